@@ -0,0 +1,108 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/Atom.h"
+
+#include <pthread.h>
+
+namespace Diadem {
+
+namespace {
+
+// Windows may be loaded on several threads, and any of them may intern new
+// names.
+pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Open-addressed hash table of interned strings. Entries are never removed,
+// so pointers to them stay valid for the life of the program.
+template <class Entry>
+class AtomPool {
+ public:
+  AtomPool() : count_(0) { slots_.resize(256, Slot()); }
+
+  const Entry* Intern(const char *s) {
+    size_t length;
+    const uint32_t hash = String::ComputeHash(s, &length);
+    size_t i = hash & (slots_.size() - 1);
+
+    for (; slots_[i].entry != NULL; i = (i + 1) & (slots_.size() - 1)) {
+      const Entry *entry = slots_[i].entry;
+
+      if ((slots_[i].hash == hash) && (entry->length == length) &&
+          (memcmp(entry->string, s, length) == 0))
+        return entry;
+    }
+
+    char *string_copy = new char[length + 1];
+    Entry *entry = new Entry;
+
+    memcpy(string_copy, s, length + 1);
+    entry->string = string_copy;
+    entry->length = length;
+    entry->index = ++count_;  // Index 0 is reserved for the empty atom.
+    slots_[i].entry = entry;
+    slots_[i].hash = hash;
+    if (count_ * 2 > slots_.size())
+      Grow();
+    return entry;
+  }
+
+ protected:
+  struct Slot {
+    Slot() : entry(NULL), hash(0) {}
+
+    const Entry *entry;
+    uint32_t hash;
+  };
+
+  Array<Slot> slots_;
+  size_t count_;
+
+  void Grow() {
+    Array<Slot> old_slots;
+
+    old_slots.swap(slots_);
+    slots_.resize(old_slots.size() * 2, Slot());
+    for (size_t i = 0; i < old_slots.size(); ++i) {
+      if (old_slots[i].entry == NULL)
+        continue;
+
+      size_t j = old_slots[i].hash & (slots_.size() - 1);
+
+      while (slots_[j].entry != NULL)
+        j = (j + 1) & (slots_.size() - 1);
+      slots_[j] = old_slots[i];
+    }
+  }
+};
+
+}  // namespace
+
+const Atom::Entry* Atom::Intern(const char *s) {
+  // Atom constants are initialized statically in many files, so the pool
+  // has to be constructed on first use rather than as a global. It is never
+  // deleted, so atoms stay valid during static destruction too.
+  static AtomPool<Entry> *pool = new AtomPool<Entry>;
+
+  if ((s == NULL) || (s[0] == '\0'))
+    return NULL;
+  pthread_mutex_lock(&pool_mutex);
+
+  const Entry* const entry = pool->Intern(s);
+
+  pthread_mutex_unlock(&pool_mutex);
+  return entry;
+}
+
+}  // namespace Diadem
@@ -0,0 +1,90 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_ATOM_H_
+#define DIADEM_ATOM_H_
+
+#include "Diadem/Wrappers.h"
+
+namespace Diadem {
+
+// An Atom is an interned string. Each distinct string is stored once in a
+// global pool, so atoms can be compared by pointer and used as small array
+// indices. Constructing an Atom from a string looks it up in the pool, so
+// that should happen once at the boundary (such as in the parser), not in
+// inner loops.
+class Atom {
+ public:
+  Atom() : entry_(NULL) {}
+  Atom(const char *s) : entry_(Intern(s)) {}
+  Atom(const String &s) : entry_(Intern(s.Get())) {}
+
+  const char* Get() const
+    { return (entry_ == NULL) ? "" : entry_->string; }
+  operator const char*() const { return Get(); }
+
+  // The empty string is always index 0. Other atoms are numbered in the order
+  // they were interned, so the indices are dense.
+  size_t Index() const  { return (entry_ == NULL) ? 0 : entry_->index; }
+  size_t Length() const { return (entry_ == NULL) ? 0 : entry_->length; }
+  bool IsEmpty() const  { return entry_ == NULL; }
+
+  bool operator==(const Atom &a) const { return entry_ == a.entry_; }
+  bool operator!=(const Atom &a) const { return entry_ != a.entry_; }
+  bool operator==(const char *s) const { return strcmp(Get(), s) == 0; }
+  bool operator!=(const char *s) const { return strcmp(Get(), s) != 0; }
+
+ protected:
+  struct Entry {
+    const char *string;
+    size_t length;
+    size_t index;
+  };
+
+  const Entry *entry_;
+
+  // Returns the pool entry for the string, adding it if necessary.
+  static const Entry* Intern(const char *s);
+};
+
+// Atoms sort alphabetically so that maps keyed by atoms, such as PropertyMap,
+// iterate in the same order as if they were keyed by strings.
+inline bool operator<(const Atom &a, const Atom &b) {
+  return (a != b) && (strcmp(a.Get(), b.Get()) < 0);
+}
+
+typedef Atom PropertyName;
+typedef Atom TypeName;
+
+// Maps atoms to values using the atom index as an array index, so lookups are
+// a bounds check and a load. Keys missing from the table return T().
+template <class T>
+class AtomTable {
+ public:
+  void Insert(const Atom &key, const T &value) {
+    if (key.Index() >= entries_.size())
+      entries_.resize(key.Index() + 1, T());
+    entries_[key.Index()] = value;
+  }
+  T Find(const Atom &key) const {
+    return (key.Index() < entries_.size()) ? entries_[key.Index()] : T();
+  }
+
+ protected:
+  Array<T> entries_;
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_ATOM_H_
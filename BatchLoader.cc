@@ -0,0 +1,103 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/BatchLoader.h"
+
+#include <libxml/parser.h>
+
+#include "Diadem/CompiledParser.h"
+#include "Diadem/Factory.h"
+#include "Diadem/Layout.h"
+#include "Diadem/LibXMLParser.h"
+
+namespace Diadem {
+
+namespace {
+
+// Appends frames for the entity and its descendants.
+void AddFrames(
+    const Entity *entity, uint32_t parent, Array<BatchLoader::Frame> *frames) {
+  const Layout* const layout = entity->GetLayout();
+
+  if (layout != NULL) {
+    const Location location = layout->GetLocation();
+    const Size size = layout->GetSize();
+    const BatchLoader::Frame frame =
+        { parent, location.x, location.y, size.width, size.height };
+
+    parent = frames->size();
+    frames->push_back(frame);
+  }
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    AddFrames(entity->ChildAt(i), parent, frames);
+}
+
+}  // namespace
+
+const uint32_t BatchLoader::kNoParent;
+
+class BatchLoader::LoadTask : public ThreadPool::Task {
+ public:
+  LoadTask(const Factory &factory, const Job &job, Result *result)
+      : factory_(factory), job_(job), result_(result) {}
+
+  virtual void Run() {
+    // The headless objects keep these for as long as they exist.
+    Headless::ThreadSettings settings(job_.metrics, job_.measurer);
+    Entity *root = NULL;
+
+    if (job_.path == NULL)
+      root = LibXMLParser(factory_).LoadEntityFromData(job_.data);
+    else if (CompiledResource::IsCompiledFile(job_.path))
+      root = CompiledParser(factory_).LoadEntityFromFile(job_.path);
+    else
+      root = LibXMLParser(factory_).LoadEntityFromFile(job_.path);
+    if (root == NULL)
+      return;
+    if (root->GetLayout() != NULL)
+      root->GetLayout()->ResizeToMinimum();
+    AddFrames(root, kNoParent, &result_->frames);
+    result_->loaded = true;
+    delete root;
+  }
+
+ protected:
+  const Factory &factory_;
+  const Job &job_;
+  Result *result_;
+};
+
+BatchLoader::BatchLoader(size_t thread_count) : pool_(thread_count) {
+  // libxml2 has to be set up before it is used on several threads.
+  xmlInitParser();
+}
+
+void BatchLoader::Run(const Array<Job> &jobs, Array<Result> *results) {
+  const Factory &factory = Factory::Shared<Headless>();
+  Array<LoadTask*> tasks;
+  Array<ThreadPool::Task*> task_pointers;
+
+  results->clear();
+  results->resize(jobs.size());
+  tasks.reserve(jobs.size());
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    tasks.push_back(new LoadTask(factory, jobs[i], &(*results)[i]));
+    task_pointers.push_back(tasks.back());
+  }
+  pool_.Run(task_pointers);
+  for (size_t i = 0; i < tasks.size(); ++i)
+    delete tasks[i];
+}
+
+}  // namespace Diadem
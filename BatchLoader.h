@@ -0,0 +1,73 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_BATCHLOADER_H_
+#define DIADEM_BATCHLOADER_H_
+
+#include "Diadem/NativeHeadless.h"
+#include "Diadem/ThreadPool.h"
+
+namespace Diadem {
+
+// Loads and lays out many windows at once with the headless classes, such as
+// for checking every window in every locale. Each job is parsed, finalized
+// and resized to its minimum size on one of the pool's threads, and its
+// geometry is recorded before the entities are deleted.
+class BatchLoader {
+ public:
+  struct Job {
+    const char *path;  // An XML or compiled resource file
+    const char *data;  // XML data, used if the path is NULL
+    // NULL uses the ones set in Headless.
+    const PlatformMetrics *metrics;
+    const Headless::TextMeasurer *measurer;
+  };
+
+  static const uint32_t kNoParent = 0xFFFFFFFF;
+
+  // One entity with a layout. Frames are listed parent first, with each
+  // frame's descendants following it in order.
+  struct Frame {
+    uint32_t parent;  // Index of the nearest ancestor with a frame
+    int32_t x, y;     // Relative to the parent
+    int32_t width, height;
+  };
+
+  struct Result {
+    Result() : loaded(false) {}
+
+    bool loaded;
+    Array<Frame> frames;
+  };
+
+  // The thread count is as for ThreadPool.
+  explicit BatchLoader(size_t thread_count = 0);
+
+  // Runs all the jobs and sets the results, one for each job. The jobs'
+  // strings, metrics and measurers must last until this returns.
+  void Run(const Array<Job> &jobs, Array<Result> *results);
+
+ protected:
+  class LoadTask;
+
+  ThreadPool pool_;
+
+ private:  // Disallow copying
+  BatchLoader(const BatchLoader&);
+  void operator=(const BatchLoader&);
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_BATCHLOADER_H_
@@ -30,15 +30,15 @@ const StringConstant
     kTransformNotEmpty = "notempty";
 
 bool Binding::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropSource) == 0) {
+  if (name == kPropSource) {
     source_ = value.Coerce<String>();
     return true;
   }
-  if (strcmp(name, kPropProperty) == 0) {
+  if (name == kPropProperty) {
     controller_.SetPropertyName(value.Coerce<String>());
     return true;
   }
-  if (strcmp(name, kPropTransform) == 0) {
+  if (name == kPropTransform) {
     const String transform = value.Coerce<String>();
 
     if (transform == kTransformNegate)
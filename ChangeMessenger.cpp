@@ -17,29 +17,129 @@
 
 namespace Diadem {
 
+struct ChangeMessenger::PendingChange {
+  String value_name;
+  Value value;
+};
+
+ChangeMessenger::ChangeMessenger() : transaction_depth_(0) {
+}
+
+// Changes from an uncommitted transaction are discarded.
+ChangeMessenger::~ChangeMessenger() {
+}
+
 void ChangeMessenger::AddObserver(const char *name, ValueObserver *observer) {
   if ((name == NULL) || (name[0] == '\0')) {
     omni_observers_.insert(observer);
+    return;
+  }
+
+  ObserverList* const list = observers_.Find(name);
+  const String name_string(name);
+
+  if (list == NULL) {
+    ObserverList new_list;
+
+    new_list.push_back(observer);
+    observers_.Insert(name_string, new_list);
   } else {
-    if (!observers_.exists(name, observer))
-      observers_.insert(name, observer);
+    if (std::find(list->begin(), list->end(), observer) != list->end())
+      return;
+    list->push_back(observer);
+  }
+
+  Array<String>* const names = observed_names_.Find(observer);
+
+  if (names == NULL) {
+    Array<String> new_names;
+
+    new_names.push_back(name_string);
+    observed_names_.Insert(observer, new_names);
+  } else {
+    names->push_back(name_string);
   }
 }
 
 void ChangeMessenger::RemoveObserver(ValueObserver *observer) {
   omni_observers_.erase(observer);
-  observers_.erase_value(observer);
+
+  const Array<String>* const names = observed_names_.Find(observer);
+
+  if (names == NULL)
+    return;
+  for (size_t i = 0; i < names->size(); ++i) {
+    ObserverList* const list = observers_.Find((*names)[i]);
+
+    DASSERT(list != NULL);
+    list->Remove(observer);
+    if (list->empty())
+      observers_.Remove((*names)[i]);
+  }
+  observed_names_.Remove(observer);
 }
 
 void ChangeMessenger::NotifyChange(
-    const char *value_name, const Value &newValue) const {
-  for (OmniObserverSet::const_iterator i = omni_observers_.begin();
-       i != omni_observers_.end(); ++i)
-    (*i)->Observe(value_name, newValue);
-  for (ObserverMap::const_iterator i = observers_.begin();
-       i != observers_.end(); ++i)
-    if (i->first == value_name)
-      i->second->Observe(value_name, newValue);
+    const String &value_name, const Value &newValue) const {
+  if (transaction_depth_ == 0) {
+    DeliverChange(value_name, newValue);
+    return;
+  }
+
+  const size_t* const index = pending_index_.Find(value_name);
+
+  if (index != NULL) {
+    pending_changes_[*index].value = newValue;
+  } else {
+    pending_index_.Insert(value_name, pending_changes_.size());
+    pending_changes_.push_back(PendingChange());
+
+    PendingChange &change = pending_changes_.back();
+
+    change.value_name = value_name;
+    change.value = newValue;
+  }
+}
+
+void ChangeMessenger::CommitChanges() {
+  DASSERT(transaction_depth_ > 0);
+  if ((transaction_depth_ == 0) || (--transaction_depth_ > 0))
+    return;
+
+  // Observers may cause more changes, which are delivered immediately since
+  // the transaction is over.
+  Array<PendingChange> changes;
+
+  changes.swap(pending_changes_);
+  pending_index_.Clear();
+  for (size_t i = 0; i < changes.size(); ++i)
+    DeliverChange(changes[i].value_name, changes[i].value);
+}
+
+void ChangeMessenger::DeliverChange(
+    const String &value_name, const Value &newValue) const {
+  // Observers may add or remove observers, which can move or free the
+  // lists, so the observers are copied first. Any that are removed before
+  // their turn are skipped.
+  if (!omni_observers_.empty()) {
+    Array<ValueObserver*> omni;
+
+    omni.assign(omni_observers_.begin(), omni_observers_.end());
+    for (size_t i = 0; i < omni.size(); ++i)
+      if (omni_observers_.count(omni[i]) != 0)
+        omni[i]->Observe(value_name, newValue);
+  }
+
+  const ObserverList* const list = observers_.Find(value_name);
+
+  if (list == NULL)
+    return;
+
+  const ObserverList observers(*list);
+
+  for (size_t i = 0; i < observers.size(); ++i)
+    if (observed_names_.Find(observers[i]) != NULL)
+      observers[i]->Observe(value_name, newValue);
 }
 
 String ChangeMessenger::GetPropertyPath(
@@ -48,14 +148,14 @@ String ChangeMessenger::GetPropertyPath(
     return String();
 
   // 1 for period, 1 for terminator
-  const size_t length = strlen(name) + 1 + strlen(property) + 1;
+  const size_t length = strlen(name) + 1 + property.Length() + 1;
   char *path = new char[length];
 
-  snprintf(path, length, "%s.%s", name, property);
+  snprintf(path, length, "%s.%s", name, property.Get());
   return String(path, String::kAdoptBuffer);
 }
 
-void ValueObserver::Observe(PropertyName name, const Value &v) {
+void ValueObserver::Observe(StringConstant name, const Value &v) {
   ObserveImp(name, (transformer_ == NULL) ? v : (*transformer_)(v));
 }
 
@@ -64,7 +164,7 @@ void ValueObserver::SetTransformer(ValueTransformer *transformer) {
   transformer_ = transformer;
 }
 
-void EntityController::ObserveImp(PropertyName name, const Value &v) {
+void EntityController::ObserveImp(StringConstant name, const Value &v) {
   entity_->SetProperty(property_, v);
 }
 
@@ -15,6 +15,7 @@
 #ifndef DIADEM_CHANGEMESSENGER_H_
 #define DIADEM_CHANGEMESSENGER_H_
 
+#include "Diadem/Atom.h"
 #include "Diadem/Base.h"
 #include "Diadem/Wrappers.h"
 
@@ -30,15 +31,35 @@ class ValueTransformer;
 // that name. Every window will have one ChangeMessenger to communicate changes.
 class ChangeMessenger : public Base {
  public:
-  ChangeMessenger() {}
+  // Defined where PendingChange is complete.
+  ChangeMessenger();
+  ~ChangeMessenger();
 
   // Adds an observer to be notified of changes in a named value. If name is
   // NULL or empty, observer will be notified of all changes.
   void AddObserver(const char *name, ValueObserver *observer);
   // Removes an observer from all notifications.
   void RemoveObserver(ValueObserver *observer);
-  // Notifies all appropriate observers that a value has changed.
-  void NotifyChange(const char *value_name, const Value &newValue) const;
+  // Notifies all appropriate observers that a value has changed. Observers
+  // may be added or removed during the notification. New observers are not
+  // notified of the change being delivered, and removed ones are not
+  // notified after they are removed.
+  void NotifyChange(const String &value_name, const Value &newValue) const;
+  // Returns true if a change to the named value would reach any observer.
+  // This is a hash lookup, so callers can use it to skip computing values
+  // that nobody is listening for.
+  bool HasObservers(const String &value_name) const {
+    return !omni_observers_.empty() || (observers_.Find(value_name) != NULL);
+  }
+
+  // Between BeginChanges and CommitChanges, notifications are held instead of
+  // delivered. Repeated changes to the same value are coalesced, and on commit
+  // the observers of each changed value are notified once with the final
+  // value, in the order the values first changed. Transactions may be nested;
+  // notifications are delivered when the outermost one is committed.
+  void BeginChanges() { ++transaction_depth_; }
+  void CommitChanges();
+  bool InTransaction() const { return transaction_depth_ > 0; }
 
   // Returns the path used for listening to value changes: "name.property".
   static String GetPropertyPath(
@@ -46,9 +67,55 @@ class ChangeMessenger : public Base {
 
  protected:
   typedef Set<ValueObserver*> OmniObserverSet;
-  typedef MultiMap<String, ValueObserver*> ObserverMap;
+  typedef Array<ValueObserver*> ObserverList;
+  typedef HashMap<String, ObserverList> ObserverMap;
+  typedef HashMap<ValueObserver*, Array<String> > ObservedNameMap;
   OmniObserverSet omni_observers_;
+  // Observers for each value name, so notifying only touches the observers
+  // that are interested.
   ObserverMap observers_;
+  // The reverse of observers_: the names each observer is registered for.
+  ObservedNameMap observed_names_;
+
+  // A held change, defined in ChangeMessenger.cpp because Value.h depends on
+  // this header.
+  struct PendingChange;
+
+  // Changes held during a transaction, and their indices by name.
+  size_t transaction_depth_;
+  mutable Array<PendingChange> pending_changes_;
+  mutable HashMap<String, size_t> pending_index_;
+
+  // Delivers a notification without checking for a transaction.
+  void DeliverChange(const String &value_name, const Value &value) const;
+
+ private:
+  // Disallow copying
+  ChangeMessenger(const ChangeMessenger&);
+  void operator=(const ChangeMessenger&);
+};
+
+// Holds change notifications for the lifetime of the object.
+class ChangeTransaction {
+ public:
+  // The messenger may be NULL, in which case this does nothing.
+  explicit ChangeTransaction(ChangeMessenger *messenger)
+      : messenger_(messenger) {
+    if (messenger_ != NULL)
+      messenger_->BeginChanges();
+  }
+  ~ChangeTransaction() {
+    if (messenger_ != NULL)
+      messenger_->CommitChanges();
+  }
+
+ protected:
+  ChangeMessenger *messenger_;
+
+ private:
+  // Disallow copying
+  ChangeTransaction(const ChangeTransaction&);
+  void operator=(const ChangeTransaction&);
 };
 
 // Modifies a value before it is passed on to an abserver.
@@ -67,7 +134,7 @@ class ValueObserver : public Base {
 
   // Called by ChangeMessenger::NotifyChange.
   // Subclasses should override ObserveImp.
-  void Observe(PropertyName name, const Value &v);
+  void Observe(StringConstant name, const Value &v);
 
   void SetTransformer(ValueTransformer *transformer);
 
@@ -75,7 +142,7 @@ class ValueObserver : public Base {
   ValueTransformer *transformer_;
 
   // The named value has changed to a new (maybe transformed) value
-  virtual void ObserveImp(PropertyName name, const Value &v) = 0;
+  virtual void ObserveImp(StringConstant name, const Value &v) = 0;
 };
 
 // An observer that applies a changed value to a specified property of the
@@ -90,13 +157,13 @@ class EntityController : public ValueObserver {
   void SetEntity(Entity *entity) { entity_ = entity; }
   void SetPropertyName(PropertyName property) { property_ = property; }
   Entity* GetEntity() const { return entity_; }
-  const String& GetPropertyName() const { return property_; }
+  PropertyName GetPropertyName() const { return property_; }
 
  protected:
   Entity *entity_;
-  String property_;
+  PropertyName property_;
 
-  virtual void ObserveImp(PropertyName name, const Value &v);
+  virtual void ObserveImp(StringConstant name, const Value &v);
 };
 
 // Returns the negation of v as a bool.
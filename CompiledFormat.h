@@ -0,0 +1,81 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_COMPILEDFORMAT_H_
+#define DIADEM_COMPILEDFORMAT_H_
+
+#include "Diadem/Wrappers.h"
+
+namespace Diadem {
+
+// The layout of compiled (.demb) resource files, which are written by
+// LibXMLCompiler and read by CompiledParser. Everything the XML parser would
+// work out at load time is done by the compiler: entities for other
+// platforms are removed, names are collected so they can be interned all at
+// once, and widths and heights are parsed into their amounts and units.
+//
+// A file is a header followed by tables of fixed-size records, and then the
+// characters of all the strings, each with a null terminator. Offsets are
+// from the start of the file and are multiples of 4. Numbers are in the byte
+// order of the platform that compiled the file.
+
+const char kCompiledMagic[4] = { 'D', 'E', 'M', 'B' };
+const uint32_t kCompiledVersion = 1;
+
+struct CompiledHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t file_size;
+  uint32_t os;  // String index of the platform it was compiled for
+  // Strings 0 to name_count-1 are type and property names. String 0 is
+  // always the empty string.
+  uint32_t string_count, name_count, strings_offset;
+  uint32_t entity_count, entities_offset;
+  uint32_t property_count, properties_offset;
+  uint32_t characters_size, characters_offset;
+};
+
+struct CompiledString {
+  uint32_t offset;  // Within the characters
+  uint32_t length;
+  uint32_t hash;    // As computed by String::ComputeHash
+};
+
+// Entities are listed parent first, with each entity's descendants following
+// it in order. Entities with the same properties may share them.
+struct CompiledEntity {
+  uint32_t type;  // String index
+  uint32_t first_property, property_count;
+  uint32_t end;   // Index of the entity after its last descendant
+};
+
+enum CompiledPropertyKind {
+  kCompiledPropertyString,
+  kCompiledPropertyWidth,   // The string is parsed into the size fields
+  kCompiledPropertyHeight,
+};
+
+struct CompiledProperty {
+  uint32_t name, value;  // String indices
+  uint32_t kind;         // CompiledPropertyKind
+  // For widths and heights: the SizeOption, and if that is kSizeExplicit,
+  // the amount and Unit.
+  int32_t size_option;
+  uint32_t units;
+  float amount;
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_COMPILEDFORMAT_H_
@@ -0,0 +1,349 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/CompiledParser.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Diadem/CompiledFormat.h"
+#include "Diadem/Layout.h"
+#include "Diadem/Value.h"
+
+namespace Diadem {
+
+namespace {
+
+// A read-only mapping of a whole file.
+class MappedFile : public SharedStorage {
+ public:
+  MappedFile(void *data, size_t size) : data_(data), size_(size) {}
+
+ protected:
+  ~MappedFile() { munmap(data_, size_); }
+
+  void *data_;
+  size_t size_;
+};
+
+// A copy of data that was passed in memory.
+class CopiedData : public SharedStorage {
+ public:
+  CopiedData(const char *data, size_t size) : data_(new char[size]) {
+    memcpy(data_, data, size);
+  }
+
+  const char* Get() const { return data_; }
+
+ protected:
+  ~CopiedData() { delete[] data_; }
+
+  char *data_;
+};
+
+// Checks that a table of records lies within the file.
+bool TableFits(uint32_t offset, uint32_t count, size_t record_size,
+               size_t file_size) {
+  return (offset % 4 == 0) && (offset <= file_size) &&
+         (count <= (file_size - offset) / record_size);
+}
+
+// Checks the header and the tables it describes, so that nothing outside
+// the data can be read while loading.
+bool IsValid(const char *data, size_t size) {
+  if (size < sizeof(CompiledHeader))
+    return false;
+
+  const CompiledHeader &header = *reinterpret_cast<const CompiledHeader*>(data);
+
+  if ((memcmp(header.magic, kCompiledMagic, sizeof(kCompiledMagic)) != 0) ||
+      (header.version != kCompiledVersion) || (header.file_size != size) ||
+      !TableFits(header.strings_offset, header.string_count,
+                 sizeof(CompiledString), size) ||
+      !TableFits(header.entities_offset, header.entity_count,
+                 sizeof(CompiledEntity), size) ||
+      !TableFits(header.properties_offset, header.property_count,
+                 sizeof(CompiledProperty), size) ||
+      !TableFits(header.characters_offset, header.characters_size, 1, size) ||
+      (header.name_count == 0) || (header.name_count > header.string_count) ||
+      (header.os >= header.string_count) || (header.entity_count == 0))
+    return false;
+
+  const CompiledString* const strings =
+      reinterpret_cast<const CompiledString*>(data + header.strings_offset);
+  const char* const characters = data + header.characters_offset;
+
+  for (uint32_t i = 0; i < header.string_count; ++i) {
+    if ((strings[i].offset >= header.characters_size) ||
+        (strings[i].length >= header.characters_size - strings[i].offset) ||
+        (characters[strings[i].offset + strings[i].length] != '\0'))
+      return false;
+  }
+  if (strings[0].length != 0)
+    return false;
+
+  const CompiledProperty* const properties =
+      reinterpret_cast<const CompiledProperty*>(
+          data + header.properties_offset);
+
+  for (uint32_t i = 0; i < header.property_count; ++i) {
+    const CompiledProperty &property = properties[i];
+
+    if ((property.name >= header.name_count) ||
+        (property.value >= header.string_count) ||
+        (property.kind > kCompiledPropertyHeight) ||
+        (property.size_option < kSizeFill) ||
+        (property.size_option > kSizeExplicit) ||
+        (property.units > kUnitIndent))
+      return false;
+  }
+
+  // The first entity is the root, and the others must each lie within
+  // their parents.
+  const CompiledEntity* const entities =
+      reinterpret_cast<const CompiledEntity*>(data + header.entities_offset);
+  Stack<uint32_t> ends;
+
+  if (entities[0].end != header.entity_count)
+    return false;
+  ends.push(header.entity_count);
+  for (uint32_t i = 0; i < header.entity_count; ++i) {
+    const CompiledEntity &entity = entities[i];
+
+    while (ends.top() == i)  // The entity count at the bottom stays
+      ends.pop();
+    if ((entity.type >= header.name_count) ||
+        (entity.first_property > header.property_count) ||
+        (entity.property_count >
+             header.property_count - entity.first_property) ||
+        (entity.end <= i) || (entity.end > ends.top()))
+      return false;
+    ends.push(entity.end);
+  }
+  return true;
+}
+
+}  // namespace
+
+bool CompiledResource::IsCompiledFile(const char *path) {
+  FILE* const file = fopen(path, "rb");
+
+  if (file == NULL)
+    return false;
+
+  char magic[sizeof(kCompiledMagic)];
+  const bool compiled =
+      (fread(magic, 1, sizeof(magic), file) == sizeof(magic)) &&
+      (memcmp(magic, kCompiledMagic, sizeof(magic)) == 0);
+
+  fclose(file);
+  return compiled;
+}
+
+CompiledResource* CompiledResource::LoadFile(const char *path) {
+  const int file = open(path, O_RDONLY);
+
+  if (file == -1)
+    return NULL;
+
+  struct stat info;
+  void *data = MAP_FAILED;
+
+  if ((fstat(file, &info) == 0) && (info.st_size > 0))
+    data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+  close(file);
+  if (data == MAP_FAILED)
+    return NULL;
+
+  MappedFile* const mapping = new MappedFile(data, info.st_size);
+  CompiledResource* const result =
+      Create(static_cast<const char*>(data), info.st_size, mapping);
+
+  mapping->Release();
+  return result;
+}
+
+CompiledResource* CompiledResource::LoadData(const char *data, size_t size) {
+  if ((data == NULL) || (size < sizeof(CompiledHeader)))
+    return NULL;
+
+  CopiedData* const copy = new CopiedData(data, size);
+  CompiledResource* const result = Create(copy->Get(), size, copy);
+
+  copy->Release();
+  return result;
+}
+
+CompiledResource* CompiledResource::LoadData(const char *data) {
+  if (data == NULL)
+    return NULL;
+
+  // The size is in the header, which may not be aligned.
+  CompiledHeader header;
+
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, kCompiledMagic, sizeof(kCompiledMagic)) != 0)
+    return NULL;
+  return LoadData(data, header.file_size);
+}
+
+CompiledResource* CompiledResource::Create(
+    const char *data, size_t size, SharedStorage *storage) {
+  if (!IsValid(data, size))
+    return NULL;
+
+  CompiledResource* const resource = new CompiledResource(data, storage);
+  const CompiledString &os = resource->strings_[resource->header_->os];
+
+  if (strcmp(resource->characters_ + os.offset,
+             FactorySession::OSName()) != 0) {
+    delete resource;
+    return NULL;
+  }
+  return resource;
+}
+
+CompiledResource::CompiledResource(const char *data, SharedStorage *storage)
+    : storage_(storage),
+      header_(reinterpret_cast<const CompiledHeader*>(data)),
+      strings_(reinterpret_cast<const CompiledString*>(
+          data + header_->strings_offset)),
+      entities_(reinterpret_cast<const CompiledEntity*>(
+          data + header_->entities_offset)),
+      properties_(reinterpret_cast<const CompiledProperty*>(
+          data + header_->properties_offset)),
+      characters_(data + header_->characters_offset) {
+  storage_->Retain();
+  names_.resize(header_->name_count);
+  for (uint32_t i = 0; i < header_->name_count; ++i)
+    names_[i] = TypeName(characters_ + strings_[i].offset);
+
+  // The compiler shares identical runs of properties between entities, so
+  // a run is identified by where it starts. Map 0 is for entities with no
+  // properties.
+  const size_t kNoMap = static_cast<size_t>(-1);
+  Array<size_t> run_maps;
+
+  run_maps.resize(header_->property_count, kNoMap);
+  property_maps_.reserve(header_->entity_count + 1);
+  property_maps_.resize(1);
+  entity_maps_.resize(header_->entity_count, 0);
+  for (uint32_t i = 0; i < header_->entity_count; ++i) {
+    const CompiledEntity &entity = entities_[i];
+
+    if (entity.property_count == 0)
+      continue;
+    if (run_maps[entity.first_property] != kNoMap) {
+      entity_maps_[i] = run_maps[entity.first_property];
+      continue;
+    }
+    run_maps[entity.first_property] = property_maps_.size();
+    entity_maps_[i] = property_maps_.size();
+    property_maps_.resize(property_maps_.size() + 1);
+
+    PropertyMap &property_map = property_maps_.back();
+    const CompiledProperty* const first = properties_ + entity.first_property;
+    const CompiledProperty* const last = first + entity.property_count;
+
+    for (const CompiledProperty *p = first; p != last; ++p)
+      if (p->kind == kCompiledPropertyString)
+        property_map.Insert(names_[p->name], StringAt(p->value));
+  }
+}
+
+CompiledResource::~CompiledResource() {
+  storage_->Release();
+}
+
+String CompiledResource::StringAt(uint32_t index) const {
+  const CompiledString &string = strings_[index];
+
+  return String(characters_ + string.offset, string.length, string.hash,
+                storage_);
+}
+
+Entity* CompiledResource::CreateEntities(const Factory &factory) const {
+  FactorySession session(factory);
+  Stack<uint32_t> ends;
+
+  for (uint32_t i = 0; i < header_->entity_count; ++i) {
+    for (; !ends.empty() && (ends.top() == i); ends.pop())
+      session.EndEntity();
+
+    const CompiledEntity &entity = entities_[i];
+
+    session.BeginEntity(names_[entity.type], property_maps_[entity_maps_[i]]);
+
+    // Parsed sizes go straight to the layout. Without one, the entity gets
+    // the original string.
+    Entity* const created = session.CurrentEntity();
+    const CompiledProperty* const first = properties_ + entity.first_property;
+    const CompiledProperty* const last = first + entity.property_count;
+
+    for (const CompiledProperty *p = first; p != last; ++p) {
+      if ((p->kind == kCompiledPropertyString) || (created == NULL))
+        continue;
+
+      Layout* const layout = created->GetLayout();
+      const SizeOption option = static_cast<SizeOption>(p->size_option);
+      const Unit units = static_cast<Unit>(p->units);
+
+      if (layout == NULL) {
+        created->SetProperty(names_[p->name], StringAt(p->value));
+      } else if (p->kind == kCompiledPropertyWidth) {
+        if (option == kSizeExplicit)
+          layout->SetExplicitWidth(p->amount, units);
+        else
+          layout->SetHSizeOption(option);
+      } else {
+        if (option == kSizeExplicit)
+          layout->SetExplicitHeight(p->amount, units);
+        else
+          layout->SetVSizeOption(option);
+      }
+    }
+    ends.push(entity.end);
+  }
+  for (; !ends.empty(); ends.pop())
+    session.EndEntity();
+  return session.RootEntity();
+}
+
+Entity* CompiledParser::LoadEntityFromFile(const char *path) const {
+  return LoadEntity(CompiledResource::LoadFile(path));
+}
+
+Entity* CompiledParser::LoadEntityFromData(
+    const char *data, size_t size) const {
+  return LoadEntity(CompiledResource::LoadData(data, size));
+}
+
+Entity* CompiledParser::LoadEntityFromData(const char *data) const {
+  return LoadEntity(CompiledResource::LoadData(data));
+}
+
+Entity* CompiledParser::LoadEntity(CompiledResource *resource) const {
+  if (resource == NULL)
+    return NULL;
+
+  Entity* const result = resource->CreateEntities(factory_);
+
+  delete resource;
+  return result;
+}
+
+}  // namespace Diadem
@@ -0,0 +1,100 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_COMPILEDPARSER_H_
+#define DIADEM_COMPILEDPARSER_H_
+
+#include "Diadem/Factory.h"
+
+namespace Diadem {
+
+struct CompiledEntity;
+struct CompiledHeader;
+struct CompiledProperty;
+struct CompiledString;
+class SharedStorage;
+
+// A compiled (.demb) resource, as written by LibXMLCompiler, ready to create
+// any number of entity trees. Names are interned once, and entities with the
+// same properties share one PropertyMap. Strings in the created entities
+// refer to the resource's characters instead of copying them, and keep them
+// in memory until the last of those strings is released, even if the
+// resource has been deleted. Copying those strings is not thread-safe, so a
+// resource should only create entities on one thread at a time.
+class CompiledResource : public Base {
+ public:
+  // These return NULL if the data is not valid, or was compiled for a
+  // different platform. Files are memory-mapped, so a compiled file should
+  // be replaced rather than rewritten in place. Data is copied, since the
+  // entities may outlast it.
+  static CompiledResource* LoadFile(const char *path);
+  static CompiledResource* LoadData(const char *data, size_t size);
+  // Takes the size from the data's own header, so this is only for trusted
+  // data: anything shorter than the header says will be read past its end.
+  static CompiledResource* LoadData(const char *data);
+  // The storage is retained, and must contain the size bytes at data.
+  static CompiledResource* Create(
+      const char *data, size_t size, SharedStorage *storage);
+
+  // Returns true if the file starts like a compiled resource, as opposed to
+  // an XML one.
+  static bool IsCompiledFile(const char *path);
+
+  virtual ~CompiledResource();
+
+  // Returns the root of a new tree of entities.
+  Entity* CreateEntities(const Factory &factory) const;
+
+ protected:
+  CompiledResource(const char *data, SharedStorage *storage);
+
+  SharedStorage *storage_;
+  const CompiledHeader *header_;
+  const CompiledString *strings_;
+  const CompiledEntity *entities_;
+  const CompiledProperty *properties_;
+  const char *characters_;
+  Array<TypeName> names_;
+  // The string properties for each distinct run of properties, and the
+  // index in that array for each entity.
+  Array<PropertyMap> property_maps_;
+  Array<size_t> entity_maps_;
+
+  String StringAt(uint32_t index) const;
+
+ private:  // Disallow copying
+  CompiledResource(const CompiledResource&);
+  void operator=(const CompiledResource&);
+};
+
+// Loads a compiled resource and creates one tree of entities from it.
+class CompiledParser : public Parser {
+ public:
+  explicit CompiledParser(const Factory &factory) : factory_(factory) {}
+  virtual ~CompiledParser() {}
+
+  Entity* LoadEntityFromFile(const char *path) const;
+  Entity* LoadEntityFromData(const char *data, size_t size) const;
+  // As with CompiledResource::LoadData(), only for trusted data.
+  Entity* LoadEntityFromData(const char *data) const;
+
+ protected:
+  const Factory &factory_;
+
+  Entity* LoadEntity(CompiledResource *resource) const;
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_COMPILEDPARSER_H_
@@ -13,6 +13,11 @@
 // the License.
 
 #include "Diadem/Entity.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
 #include "Diadem/Layout.h"
 #include "Diadem/Native.h"
 #include "Diadem/Value.h"
@@ -25,7 +30,8 @@ const PropertyName
     kPropEnabled = "enabled";
 
 Entity::Entity()
-    : parent_(NULL), layout_(NULL), native_(NULL),
+    : parent_(NULL), root_(this), type_index_(0),
+      layout_(NULL), native_(NULL), window_(NULL),
       button_callback_(NULL), button_data_(NULL) {
 }
 
@@ -39,26 +45,26 @@ Entity::~Entity() {
 void Entity::InitializeProperties(
     const PropertyMap &properties,
     const Factory &factory) {
-  const Array<String> keys = properties.AllKeys();
+  const Array<PropertyName> keys = properties.AllKeys();
 
   for (size_t i = 0; i < keys.size(); ++i)
     SetProperty(keys[i], properties[keys[i]]);
 }
 
-String Entity::GetTypeName() const {
+TypeName Entity::GetTypeName() const {
   if (native_ != NULL) {
-    const String native_type = native_->GetTypeName();
+    const TypeName native_type = native_->GetTypeName();
 
     if (!native_type.IsEmpty())
       return native_type;
   }
   if (layout_ != NULL) {
-    const String layout_type = layout_->GetTypeName();
+    const TypeName layout_type = layout_->GetTypeName();
 
     if (!layout_type.IsEmpty())
       return layout_type;
   }
-  return String();
+  return TypeName();
 }
 
 const size_t kMaxPathLength = 256;
@@ -67,7 +73,7 @@ String Entity::GetPath() const {
   char path[kMaxPathLength];
 
   if (name_.IsEmpty()) {
-    const String my_name = GetTypeName();
+    const TypeName my_name = GetTypeName();
 
     if (GetParent() == NULL) {
       snprintf(path, kMaxPathLength, "/%s", my_name.Get());
@@ -88,40 +94,71 @@ String Entity::GetPath() const {
 
 size_t Entity::ChildIndexByType(const Entity *child) const {
   DASSERT(child != NULL);
-  const String child_type = child->GetTypeName();
-  uint32 count = 0;
-
-  for (size_t i = 0; i < ChildrenCount(); ++i) {
-    if (ChildAt(i) == child)
-      return count + 1;
-    if (ChildAt(i)->GetTypeName() == child_type)
-      ++count;
+  if (child->parent_ != this)
+    return 0;
+  return child->type_index_;
+}
+
+void Entity::NumberLastChild() {
+  Entity* const child = children_[children_.size()-1];
+  const TypeName child_type = child->GetTypeName();
+
+  // Siblings of one type are usually added together, so the previous one
+  // tends to be close by.
+  child->type_index_ = 1;
+  for (size_t i = children_.size()-1; i > 0; --i) {
+    if (children_[i-1]->GetTypeName() == child_type) {
+      child->type_index_ = children_[i-1]->type_index_ + 1;
+      break;
+    }
+  }
+}
+
+void Entity::RenumberChildren() {
+  AtomTable<size_t> counts;
+
+  for (size_t i = 0; i < children_.size(); ++i) {
+    const TypeName type = children_[i]->GetTypeName();
+    const size_t count = counts.Find(type) + 1;
+
+    counts.Insert(type, count);
+    children_[i]->type_index_ = count;
   }
-  return 0;
 }
 
 void Entity::SetLayout(Layout *layout) {
   layout_ = layout;
   if (layout != NULL)
     layout->SetEntity(this);
+  // The type name can come from the layout.
+  if (parent_ != NULL)
+    parent_->RenumberChildren();
 }
 
 void Entity::SetNative(Native *native) {
   native_ = native;
   if (native != NULL)
     native->SetEntity(this);
+  if (parent_ != NULL)
+    parent_->RenumberChildren();
+  // Platform metrics come from the nearest native object.
+  UpdateAncestorState();
+}
+
+void Entity::UpdateAncestorState() {
+  root_ = (parent_ == NULL) ? this : parent_->root_;
+  if (layout_ != NULL)
+    layout_->AncestorsChanged();
+  for (size_t i = 0; i < children_.size(); ++i)
+    children_[i]->UpdateAncestorState();
 }
 
 Window* Entity::GetWindow() {
-  if (parent_ != NULL)
-    return parent_->GetWindow();
-  return window_;
+  return root_->window_;
 }
 
 const Window* Entity::GetWindow() const {
-  if (parent_ != NULL)
-    return parent_->GetWindow();
-  return window_;
+  return root_->window_;
 }
 
 void Entity::FactoryFinalize() {
@@ -148,22 +185,85 @@ void Entity::AddNativeChild(Entity *child) {
 }
 
 ChangeMessenger* Entity::GetChangeMessenger() {
-  if (GetParent() != NULL)
-    return GetParent()->GetChangeMessenger();
+  // The root entity is the one that overrides this if it has one.
+  if (root_ != this)
+    return root_->GetChangeMessenger();
   return NULL;
 }
 
 ChangeMessenger const* Entity::GetChangeMessenger() const {
-  if (GetParent() != NULL)
-    return GetParent()->GetChangeMessenger();
+  const Entity* const root = root_;
+
+  if (root != this)
+    return root->GetChangeMessenger();
   return NULL;
 }
 
+NameIndex* Entity::GetNameIndex() {
+  if (root_ != this)
+    return root_->GetNameIndex();
+  return NULL;
+}
+
+const NameIndex* Entity::GetNameIndex() const {
+  const Entity* const root = root_;
+
+  if (root != this)
+    return root->GetNameIndex();
+  return NULL;
+}
+
+SizeGroups* Entity::GetSizeGroups() {
+  if (root_ != this)
+    return root_->GetSizeGroups();
+  return NULL;
+}
+
+const SizeGroups* Entity::GetSizeGroups() const {
+  const Entity* const root = root_;
+
+  if (root != this)
+    return root->GetSizeGroups();
+  return NULL;
+}
+
+void Entity::SetName(const char *name) {
+  NameIndex* const index = GetNameIndex();
+
+  if (index != NULL)
+    index->Remove(name_, this);
+  name_ = name;
+  property_paths_.clear();
+  if (index != NULL)
+    index->Add(name_, this);
+}
+
+String Entity::GetPropertyPath(PropertyName property) const {
+  for (size_t i = 0; i < property_paths_.size(); ++i)
+    if (property_paths_[i].property == property)
+      return property_paths_[i].path;
+
+  const PropertyPath path =
+      { property, ChangeMessenger::GetPropertyPath(name_, property) };
+
+  property_paths_.push_back(path);
+  return path.path;
+}
+
 void Entity::AddChild(Entity *child) {
   DASSERT(child != NULL);
   if (child != NULL) {
     children_.push_back(child);
+    NumberLastChild();
     child->SetParent(this);
+
+    NameIndex* const index = GetNameIndex();
+    SizeGroups* const size_groups = GetSizeGroups();
+
+    if (index != NULL)
+      index->AddTree(child);
+    if (size_groups != NULL)
+      size_groups->AddTree(child);
     ChildAdded(child);
     AddNativeChild(child);
     if (layout_ != NULL)
@@ -175,6 +275,15 @@ void Entity::RemoveChild(Entity *child) {
   DASSERT(child->GetParent() == this);
   ChildRemoved(child);
   children_.Remove(child);
+  RenumberChildren();
+
+  NameIndex* const index = GetNameIndex();
+  SizeGroups* const size_groups = GetSizeGroups();
+
+  if (index != NULL)
+    index->RemoveTree(child);
+  if (size_groups != NULL)
+    size_groups->RemoveTree(child);
   child->SetParent(NULL);
 }
 
@@ -186,11 +295,32 @@ void Entity::AddNative(Native *n) {
 }
 
 Entity* Entity::FindByName(const char *name) {
+  const NameIndex* const index = GetNameIndex();
+
+  if ((index == NULL) || (name == NULL) || (name[0] == '\0'))
+    return SearchByName(name);
+
+  bool duplicate = false;
+  Entity* const result = index->Find(name, &duplicate);
+
+  // Duplicate names are searched for the old way so the result is the first
+  // match in the hierarchy.
+  if (duplicate)
+    return SearchByName(name);
+
+  // The result must be in this entity's part of the hierarchy.
+  for (Entity *e = result; e != NULL; e = e->GetParent())
+    if (e == this)
+      return result;
+  return NULL;
+}
+
+Entity* Entity::SearchByName(const char *name) {
   if (name_ == name)
     return this;
 
   for (size_t i = 0; i < children_.size(); ++i) {
-    Entity* result = children_[i]->FindByName(name);
+    Entity* result = children_[i]->SearchByName(name);
 
     if (result != NULL)
       return result;
@@ -198,8 +328,8 @@ Entity* Entity::FindByName(const char *name) {
   return NULL;
 }
 
-bool Entity::SetProperty(const char *name, const Value &value) {
-  if (strcmp(name, kPropName) == 0) {
+bool Entity::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropName) {
     SetName(value.Coerce<String>());
     return true;
   }
@@ -210,8 +340,8 @@ bool Entity::SetProperty(const char *name, const Value &value) {
   return false;
 }
 
-Value Entity::GetProperty(const char *name) const {
-  if (strcmp(name, kPropName) == 0)
+Value Entity::GetProperty(PropertyName name) const {
+  if (name == kPropName)
     return GetName();
 
   Value layout_result = GetLayoutProperty(name);
@@ -221,42 +351,48 @@ Value Entity::GetProperty(const char *name) const {
   return GetNativeProperty(name);
 }
 
-bool Entity::SetLayoutProperty(const char *name, const Value &value) {
+bool Entity::SetLayoutProperty(PropertyName name, const Value &value) {
   if (layout_ != NULL)
     return layout_->SetProperty(name, value);
   return false;
 }
 
-Value Entity::GetLayoutProperty(const char *name) const {
+Value Entity::GetLayoutProperty(PropertyName name) const {
   if (layout_ != NULL)
     return layout_->GetProperty(name);
   return Value();
 }
 
-bool Entity::SetNativeProperty(const char *name, const Value &value) {
+bool Entity::SetNativeProperty(PropertyName name, const Value &value) {
   if (native_ != NULL)
     return native_->SetProperty(name, value);
   return false;
 }
 
-Value Entity::GetNativeProperty(const char *name) const {
+Value Entity::GetNativeProperty(PropertyName name) const {
   if (native_ != NULL)
     return native_->GetProperty(name);
   return Value();
 }
 
 void Entity::PropertyChanged(PropertyName name) const {
-  DASSERT((name != NULL) && (name[0] != '\0'));
-  if ((name == NULL) || (name[0] == '\0'))
+  DASSERT(!name.IsEmpty());
+  if (name.IsEmpty())
     return;
   if (name_.IsEmpty())
     return;
 
   const ChangeMessenger* const messenger = GetChangeMessenger();
 
-  if (messenger != NULL)
-    messenger->NotifyChange(
-        ChangeMessenger::GetPropertyPath(name_, name), GetProperty(name));
+  if (messenger == NULL)
+    return;
+
+  const String path = GetPropertyPath(name);
+
+  // Getting the value may mean asking the native control, so only do it if
+  // someone is listening.
+  if (messenger->HasObservers(path))
+    messenger->NotifyChange(path, GetProperty(name));
 }
 
 void Entity::SetText(const char *text) {
@@ -283,6 +419,87 @@ void Entity::Clicked(Entity *target) {
     GetParent()->Clicked(target);
 }
 
+RootEntity::RootEntity() : size_groups_(new SizeGroups) {}
+
+RootEntity::~RootEntity() {
+  delete size_groups_;
+}
+
+bool NameIndex::Add(const String &name, Entity *entity) {
+  if (name.IsEmpty())
+    return true;
+
+  Entry* const existing = entries_.Find(name);
+
+  if (existing == NULL) {
+    Entry entry;
+
+    entry.entity = entity;
+    entries_.Insert(name, entry);
+    return true;
+  }
+  if ((existing->entity == entity) ||
+      (std::find(existing->others.begin(), existing->others.end(), entity) !=
+       existing->others.end()))
+    return true;
+  existing->others.push_back(entity);
+#ifndef NDEBUG
+  fprintf(stderr, "Diadem: more than one entity is named \"%s\"\n",
+          name.Get());
+#endif
+  return false;
+}
+
+void NameIndex::Remove(const String &name, Entity *entity) {
+  if (name.IsEmpty())
+    return;
+
+  Entry* const existing = entries_.Find(name);
+
+  if (existing == NULL)
+    return;
+  if (existing->entity == entity) {
+    if (existing->others.empty()) {
+      entries_.Remove(name);
+      return;
+    }
+    existing->entity = existing->others.back();
+    existing->others.pop_back();
+  } else {
+    existing->others.Remove(entity);
+  }
+}
+
+void NameIndex::AddTree(Entity *entity) {
+  Add(entity->GetName(), entity);
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    AddTree(entity->ChildAt(i));
+}
+
+void NameIndex::RemoveTree(Entity *entity) {
+  Remove(entity->GetName(), entity);
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    RemoveTree(entity->ChildAt(i));
+}
+
+Entity* NameIndex::Find(const char *name, bool *duplicate) const {
+  const Entry* const entry = entries_.Find(name);
+
+  if (duplicate != NULL)
+    *duplicate = (entry != NULL) && !entry->others.empty();
+  return (entry == NULL) ? NULL : entry->entity;
+}
+
+Array<String> NameIndex::DuplicateNames() const {
+  const Array<String> names = entries_.AllKeys();
+  Array<String> duplicates;
+
+  for (size_t i = 0; i < names.size(); ++i)
+    if (!entries_.Find(names[i])->others.empty())
+      duplicates.push_back(names[i]);
+  return duplicates;
+}
+
 bool EntityDelegate::SetProperty(PropertyName name, const Value &value) {
   return false;
 }
@@ -15,6 +15,7 @@
 #ifndef DIADEM_ENTITY_H_
 #define DIADEM_ENTITY_H_
 
+#include "Diadem/Atom.h"
 #include "Diadem/ChangeMessenger.h"
 #include "Diadem/Wrappers.h"
 
@@ -23,14 +24,54 @@ namespace Diadem {
 class Factory;
 class Layout;
 class Native;
+class SizeGroups;
 class Value;
 class Window;
-class Value;
 
-typedef Map<String, Value> PropertyMap;
+// Keys are interned once when the map is built, usually by the parser.
+typedef Map<PropertyName, Value> PropertyMap;
 
 extern const PropertyName kPropName, kPropText, kPropEnabled;
 
+// Maps names to entities for a whole hierarchy so that FindByName does not
+// have to search it. The RootEntity owns the index, and entities are added
+// and removed as they are named and as they are attached to or detached from
+// the hierarchy. A name that is given to more than one entity is recorded as
+// a duplicate instead of one entity shadowing the other.
+class NameIndex {
+ public:
+  NameIndex() {}
+
+  // Returns false if another entity already has the name.
+  bool Add(const String &name, Entity *entity);
+  void Remove(const String &name, Entity *entity);
+
+  // Adds or removes the entity and all of its descendants.
+  void AddTree(Entity *entity);
+  void RemoveTree(Entity *entity);
+
+  // Returns the first entity added with the name, or NULL if there is none.
+  // If duplicate is not NULL, it is set to whether other entities also have
+  // the name. The name is not copied, so this does not allocate.
+  Entity* Find(const char *name, bool *duplicate = NULL) const;
+
+  // Names that are currently used by more than one entity.
+  Array<String> DuplicateNames() const;
+
+ protected:
+  struct Entry {
+    Entity *entity;        // The first entity added with the name
+    Array<Entity*> others;  // The rest, if the name is a duplicate
+  };
+
+  HashMap<String, Entry> entries_;
+
+ private:
+  // Disallow copying
+  NameIndex(const NameIndex&);
+  void operator=(const NameIndex&);
+};
+
 // Basic object type: has a unique name, created from a resource.
 class Entity : public Base {
  public:
@@ -54,7 +95,8 @@ class Entity : public Base {
   virtual void AddChild(Entity *child);
   void RemoveChild(Entity *child);
 
-  // Finds and entity by name, starting from this point in the hierarchy.
+  // Finds an entity by name, starting from this point in the hierarchy. If
+  // the hierarchy has a NameIndex, this is a hash lookup.
   Entity* FindByName(const char *name);
 
   // The purpose of a path is to have a unique string for an entity even when
@@ -70,7 +112,7 @@ class Entity : public Base {
 
   // Returns the type name that would be used for the entity in a resource file.
   // Delegates to the Native or Layout object.
-  virtual String GetTypeName() const;
+  virtual TypeName GetTypeName() const;
 
   /// Gets/sets the Layout helper object which handles all dialog layout.
   void SetLayout(Layout *layout);
@@ -86,6 +128,16 @@ class Entity : public Base {
   virtual ChangeMessenger* GetChangeMessenger();
   virtual ChangeMessenger const* GetChangeMessenger() const;
 
+  // Returns the name index for the hierarchy, or NULL if the root entity
+  // does not have one.
+  virtual NameIndex* GetNameIndex();
+  virtual const NameIndex* GetNameIndex() const;
+
+  // Returns the registry of layout width and height names for the hierarchy,
+  // or NULL if the root entity does not have one.
+  virtual SizeGroups* GetSizeGroups();
+  virtual const SizeGroups* GetSizeGroups() const;
+
   // SetWindow should only be called on the root entity.
   void SetWindow(Window *window) {
     DASSERT(parent_ == NULL);
@@ -94,6 +146,10 @@ class Entity : public Base {
   Window* GetWindow();
   const Window* GetWindow() const;
 
+  // The top of the hierarchy, which may be the entity itself.
+  Entity* GetRoot()             { return root_; }
+  const Entity* GetRoot() const { return root_; }
+
   // Gets/sets a named property, which may be delegated to a helper.
   virtual bool SetProperty(PropertyName name, const Value &value);
   virtual Value GetProperty(PropertyName name) const;
@@ -107,15 +163,19 @@ class Entity : public Base {
   virtual Value GetNativeProperty(PropertyName name) const;
 
   // Notification that a property value has changed. If the entity's name is
-  // set, this calls GetChangeMessenger()->NotifyChange().
+  // set and the change has observers, this calls
+  // GetChangeMessenger()->NotifyChange() with the current value.
   virtual void PropertyChanged(PropertyName name) const;
 
   // Every Entity can have a name, which should be unique within the hierarchy
-  // if it is not empty.
-  void SetName(const char *name)
-    { name_ = name; }
-  const char* GetName() const
+  // if it is not empty. Duplicates are tracked by the NameIndex.
+  void SetName(const char *name);
+  const String& GetName() const
     { return name_; }
+  // Returns the path that changes to the property are published under, as
+  // from ChangeMessenger::GetPropertyPath(). Paths are cached per entity so
+  // that repeated changes don't format and hash a new string each time.
+  String GetPropertyPath(PropertyName property) const;
 
   // Shortcuts to setting/getting kPropText
   void SetText(const char *text);
@@ -140,22 +200,49 @@ class Entity : public Base {
  protected:
   String name_;
   Entity *parent_;
+  // The top of the hierarchy, or this entity if it has no parent. Kept up to
+  // date by UpdateAncestorState so that finding the messenger, name index and
+  // window doesn't have to walk up the hierarchy.
+  Entity *root_;
   Array<Entity*> children_;
+  // This entity's position among its siblings of the same type, counting
+  // from 1, for ChildIndexByType(). Set by the parent when the children or
+  // their types change.
+  size_t type_index_;
   Layout *layout_;
   Native *native_;
   Window *window_;
   ButtonCallback button_callback_;
   void *button_data_;
 
+  struct PropertyPath {
+    PropertyName property;
+    String path;
+  };
+
+  // Cached results of GetPropertyPath(), cleared when the name changes.
+  // Entities publish few properties, so a linear search is enough.
+  mutable Array<PropertyPath> property_paths_;
+
   // Called by FactoryFinalize() once the Native and Layout helpers have also
   // been finalized.
   virtual void Finalize() {}
 
+  // Sets type_index_ for a child that was just appended, or for all the
+  // children after one is removed or changes its type.
+  void NumberLastChild();
+  void RenumberChildren();
+
   void SetParent(Entity *parent) {
     parent_ = parent;
+    UpdateAncestorState();
     ParentAdded();
   }
 
+  // Updates the state that the entity and its descendants cache from their
+  // ancestors, after the entity is moved or gets a new Native.
+  void UpdateAncestorState();
+
   // Called by AddChild and RemoveChild in case subclasses need to take
   // special action
   virtual void ChildAdded(Entity *child) {}
@@ -165,6 +252,9 @@ class Entity : public Base {
   // Add a new child recursively in case it has children
   void AddNativeChild(Entity *child);
 
+  // Searches the hierarchy without using the name index.
+  Entity* SearchByName(const char *name);
+
  private:
   // Disallow copy and assign
   Entity(const Entity&);
@@ -174,13 +264,56 @@ class Entity : public Base {
 // The entity at the top of the hierarchy, containing any window-global objects
 class RootEntity : public Entity {
  public:
-  RootEntity() {}
+  RootEntity();
+  ~RootEntity();
 
   ChangeMessenger* GetChangeMessenger()             { return &messenger_; }
   const ChangeMessenger* GetChangeMessenger() const { return &messenger_; }
 
+  NameIndex* GetNameIndex()             { return &names_; }
+  const NameIndex* GetNameIndex() const { return &names_; }
+
+  SizeGroups* GetSizeGroups()             { return size_groups_; }
+  const SizeGroups* GetSizeGroups() const { return size_groups_; }
+
  protected:
   ChangeMessenger messenger_;
+  NameIndex names_;
+  SizeGroups *size_groups_;  // Owning reference
+};
+
+// Maps property names to the member functions of T that set and get them, so
+// SetProperty and GetProperty can find the handler with one array lookup
+// instead of comparing the name against every property the class supports.
+// A class builds its table once, typically in a static Properties() method,
+// and falls back to its superclass for names that are not in the table.
+template <class T>
+class PropertyTable {
+ public:
+  // A setter returns false if the property should be passed on to be handled
+  // elsewhere. A getter can do the same by returning an invalid Value.
+  typedef bool (T::*Setter)(const Value &value);
+  typedef Value (T::*Getter)() const;
+
+  PropertyTable& Add(PropertyName name, Setter setter, Getter getter = NULL) {
+    const Accessors accessors = { setter, getter };
+
+    table_.Insert(name, accessors);
+    return *this;
+  }
+
+  Setter GetSetter(PropertyName name) const
+    { return table_.Find(name).setter; }
+  Getter GetGetter(PropertyName name) const
+    { return table_.Find(name).getter; }
+
+ protected:
+  struct Accessors {
+    Setter setter;
+    Getter getter;
+  };
+
+  AtomTable<Accessors> table_;
 };
 
 // Superclass for Layout and Native. In a previous incarnation, these features
@@ -197,7 +330,7 @@ class EntityDelegate : public Base {
   Entity* GetEntity()             { return entity_; }
   const Entity* GetEntity() const { return entity_; }
 
-  virtual String GetTypeName() const { return String(); }
+  virtual TypeName GetTypeName() const { return TypeName(); }
 
   virtual void InitializeProperties(const PropertyMap &properties) {}
 
@@ -19,8 +19,6 @@
 #include "Diadem/Native.h"
 #include "Diadem/Value.h"
 
-#define kOSProperty "os"
-
 #if TARGET_OS_MAC
 #define kOSName "mac"
 #elif TARGET_OS_WIN32
@@ -31,6 +29,8 @@
 
 namespace Diadem {
 
+static const PropertyName kOSProperty = "os";
+
 void Factory::RegisterBasicClasses() {
   RegisterCreator(
       kTypeNameBinding,
@@ -61,12 +61,34 @@ void Factory::RegisterBasicClasses() {
       NULL, NULL);
 }
 
+void Factory::Seal() {
+  if (sealed_)
+    return;
+
+  const Array<TypeName> names = registry_.AllKeys();
+
+  for (size_t i = 0; i < names.size(); ++i)
+    creators_.Insert(names[i], registry_[names[i]]);
+  sealed_ = true;
+}
+
+Factory* Factory::CreateSealed(void (*set_up)(Factory*)) {
+  Factory* const factory = new Factory;
+
+  (*set_up)(factory);
+  factory->Seal();
+  return factory;
+}
+
 Entity* Factory::CreateEntity(
-      const char *class_name, const PropertyMap &properties) const {
-  if (!registry_.Exists(class_name))
+      TypeName class_name, const PropertyMap &properties) const {
+  // Missing names get empty creators either way.
+  const CreatorFunctions creators = sealed_ ?
+      creators_.Find(class_name) : registry_[class_name];
+
+  if (creators.entity_creator == NULL)
     return NULL;
 
-  const CreatorFunctions creators = registry_[String(class_name)];
   Entity* const entity = (*creators.entity_creator)();
 
   if (entity == NULL)
@@ -91,10 +113,17 @@ Entity* Factory::CreateEntity(
   return entity;
 }
 
+const char* FactorySession::OSName() {
+  return kOSName;
+}
+
 void FactorySession::BeginEntity(
-    const char *name, const PropertyMap &properties) {
-  if (properties.Exists(kOSProperty) &&
-      properties[kOSProperty].Coerce<String>() != kOSName) {
+    TypeName name, const PropertyMap &properties) {
+  // Entities for other platforms are skipped along with their contents.
+  if ((skip_depth_ != 0) ||
+      (properties.Exists(kOSProperty) &&
+       properties[kOSProperty].Coerce<String>() != kOSName)) {
+    ++skip_depth_;
     return;
   }
 
@@ -112,6 +141,11 @@ void FactorySession::BeginEntity(
 }
 
 void FactorySession::EndEntity() {
+  if (skip_depth_ != 0) {
+    --skip_depth_;
+    return;
+  }
+
   Entity* const current_entity = CurrentEntity();
 
   if ((current_entity != NULL) && (current_entity->GetParent() == NULL))
@@ -20,10 +20,13 @@
 namespace Diadem {
 
 // The Factory contains a registry of entity names and the types of objects
-// that should be created for them.
+// that should be created for them. Once all the classes are registered, the
+// factory can be sealed. A sealed factory can't be changed, and looks up
+// creators by atom index instead of searching the registry, so it can be
+// shared by any number of sessions on any number of threads.
 class Factory : public Base {
  public:
-  Factory() { RegisterBasicClasses(); }
+  Factory() : sealed_(false) { RegisterBasicClasses(); }
 
   typedef Entity* (*CreateEntityFunction)();
   typedef Layout* (*CreateLayoutFunction)();
@@ -37,7 +40,7 @@ class Factory : public Base {
     CreateNativeFunction native_creator;
   };
 
-  typedef Map<String, CreatorFunctions> CreationRegistry;
+  typedef Map<TypeName, CreatorFunctions> CreationRegistry;
   typedef CreationRegistry::Pair CreationEntry;
 
   template <class T, class C>
@@ -59,23 +62,27 @@ class Factory : public Base {
   const CreationRegistry& Registry() const
     { return registry_; }
   void RegisterCreator(
-      const char *class_name,
+      TypeName class_name,
       CreateEntityFunction entity_creator,
       CreateLayoutFunction layout_creator,
       CreateNativeFunction native_creator) {
+    DASSERT(!sealed_);
+    if (sealed_)
+      return;
+
     CreatorFunctions functions = {
         entity_creator, layout_creator, native_creator };
-    registry_.Insert(String(class_name), functions);
+    registry_.Insert(class_name, functions);
   }
 
   // Registers a class name with no layout or native helper.
   template <class T>
-  void Register(const char *class_name)
+  void Register(TypeName class_name)
     { RegisterCreator(class_name, &Creator<T, Entity>::Create, NULL, NULL); }
 
   // Native subclasses should have typedefs named EntityType and LayoutType.
   template <class T>
-  void RegisterNative(const char *class_name) {
+  void RegisterNative(TypeName class_name) {
     RegisterCreator(
         class_name,
         &Creator<typename T::EntityType, Entity>::Create,
@@ -87,17 +94,36 @@ class Factory : public Base {
   // corresponding creator functions, initialized with the given properties.
   // Returns NULL if the name is not found.
   Entity* CreateEntity(
-      const char *class_name, const PropertyMap &properties) const;
+      TypeName class_name, const PropertyMap &properties) const;
 
-  bool IsRegistered(const char *class_name) {
-    return registry_.Exists(class_name);
+  bool IsRegistered(TypeName class_name) const {
+    return sealed_ ? (creators_.Find(class_name).entity_creator != NULL)
+                   : registry_.Exists(class_name);
   }
 
   // Registers all standard, platform-independent classes.
   void RegisterBasicClasses();
 
+  // Builds the lookup table. Nothing can be registered after this.
+  void Seal();
+  bool IsSealed() const { return sealed_; }
+
+  // Returns a sealed factory set up by Platform::SetUpFactory. It is created
+  // the first time it is needed, and never deleted.
+  template <class Platform>
+  static const Factory& Shared() {
+    static const Factory* const factory =
+        CreateSealed(&Platform::SetUpFactory);
+
+    return *factory;
+  }
+
  protected:
   CreationRegistry registry_;
+  bool sealed_;
+  AtomTable<CreatorFunctions> creators_;  // Filled in by Seal()
+
+  static Factory* CreateSealed(void (*set_up)(Factory*));
 };
 
 // The FactorySession is used by the Parser object to construct the hierarchy
@@ -105,11 +131,15 @@ class Factory : public Base {
 class FactorySession : public Base {
  public:
   explicit FactorySession(const Factory &factory)
-      : factory_(factory), root_(NULL) {}
+      : factory_(factory), root_(NULL), skip_depth_(0) {}
 
-  void BeginEntity(const char *name, const PropertyMap &properties);
+  void BeginEntity(TypeName name, const PropertyMap &properties);
   void EndEntity();
 
+  // The value of the os property for entities that are loaded on this
+  // platform. Entities with other values are skipped.
+  static const char* OSName();
+
   Entity* RootEntity() { return root_; }
   Entity* CurrentEntity()
       { return entity_stack_.empty() ? NULL : entity_stack_.top(); }
@@ -118,6 +148,7 @@ class FactorySession : public Base {
   const Factory &factory_;
   Stack<Entity*> entity_stack_;
   Entity *root_;
+  size_t skip_depth_;  // Nesting depth inside an entity that is skipped
 
  private:  // Disallow copying
   FactorySession(const FactorySession&);
@@ -132,6 +163,10 @@ class Parser : public Base {
   virtual ~Parser() {}
 
   virtual Entity* LoadEntityFromFile(const char *path) const { return NULL; }
+  // The data's length is not given, so text formats rely on its terminator
+  // and binary ones on their own headers. Data that may be short or damaged
+  // should be loaded through an interface that takes the size, such as
+  // CompiledParser's.
   virtual Entity* LoadEntityFromData(const char *data) const { return NULL; }
 };
 
@@ -0,0 +1,990 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/FlatLayout.h"
+
+#include <algorithm>
+
+#include "Diadem/ThreadPool.h"
+
+namespace Diadem {
+
+namespace {
+
+// These match the LayoutContainer helpers, with the direction passed in.
+inline int32_t& StreamDim(uint8_t d, Size &s)
+  { return (d == Layout::kLayoutRow)    ? s.width : s.height; }
+inline int32_t StreamDim(uint8_t d, const Size &s)
+  { return (d == Layout::kLayoutRow)    ? s.width : s.height; }
+inline int32_t& CrossDim(uint8_t d, Size &s)
+  { return (d == Layout::kLayoutColumn) ? s.width : s.height; }
+inline int32_t CrossDim(uint8_t d, const Size &s)
+  { return (d == Layout::kLayoutColumn) ? s.width : s.height; }
+inline int32_t& StreamLoc(uint8_t d, Location &l)
+  { return (d == Layout::kLayoutRow)    ? l.x : l.y; }
+inline int32_t StreamLoc(uint8_t d, const Location &l)
+  { return (d == Layout::kLayoutRow)    ? l.x : l.y; }
+inline int32_t& CrossLoc(uint8_t d, Location &l)
+  { return (d == Layout::kLayoutColumn) ? l.x : l.y; }
+inline int32_t CrossLoc(uint8_t d, const Location &l)
+  { return (d == Layout::kLayoutColumn) ? l.x : l.y; }
+inline int32_t& StreamBefore(uint8_t d, Spacing &s)
+  { return (d == Layout::kLayoutRow) ? s.left : s.top; }
+inline int32_t StreamBefore(uint8_t d, const Spacing &s)
+  { return (d == Layout::kLayoutRow) ? s.left : s.top; }
+inline int32_t& StreamAfter(uint8_t d, Spacing &s)
+  { return (d == Layout::kLayoutRow) ? s.right : s.bottom; }
+inline int32_t StreamAfter(uint8_t d, const Spacing &s)
+  { return (d == Layout::kLayoutRow) ? s.right : s.bottom; }
+inline int32_t& CrossBefore(uint8_t d, Spacing &s)
+  { return (d == Layout::kLayoutColumn) ? s.left : s.top; }
+inline int32_t CrossBefore(uint8_t d, const Spacing &s)
+  { return (d == Layout::kLayoutColumn) ? s.left : s.top; }
+inline int32_t& CrossAfter(uint8_t d, Spacing &s)
+  { return (d == Layout::kLayoutColumn) ? s.right : s.bottom; }
+inline int32_t CrossAfter(uint8_t d, const Spacing &s)
+  { return (d == Layout::kLayoutColumn) ? s.right : s.bottom; }
+
+}  // namespace
+
+class FlatLayout::MeasureTask : public ThreadPool::Task {
+ public:
+  MeasureTask(FlatLayout *layout, uint32_t node)
+      : layout_(layout), node_(node) {}
+
+  virtual void Run() { layout_->CalculateMinimumSize(node_); }
+
+ protected:
+  FlatLayout *layout_;
+  uint32_t node_;
+};
+
+void FlatLayout::ResizeToMinimum() {
+  GeometryBatch batch(root_);
+
+  if (!Flatten()) {
+    root_->ResizeToMinimum();
+    return;
+  }
+  min_sizes_valid_[0] = false;
+  MeasureInParallel();
+
+  size_t iterations = 0;
+  bool converged = false;
+
+  for (; iterations < kMaxLayoutIterations; ++iterations) {
+    const Size min = GetMinimumSize(0);
+
+    converged = (min == sizes_[0]) && !needs_layout_[0];
+    if (converged)
+      break;
+    SetSize(0, min);
+    if (min != sizes_[0])
+      min_sizes_valid_[0] = false;
+  }
+  WriteBack();
+  if (Layout::monitor_ != NULL)
+    Layout::monitor_->PassFinished(root_, iterations, converged);
+}
+
+void FlatLayout::SetSize(const Size &size) {
+  GeometryBatch batch(root_);
+
+  if (!Flatten()) {
+    root_->SetSize(size);
+    return;
+  }
+  if (needs_layout_[0] || (size != sizes_[0]))
+    MeasureInParallel();
+  SetSize(0, size);
+  WriteBack();
+}
+
+void FlatLayout::UpdateLayout() {
+  GeometryBatch batch(root_);
+
+  if (!Flatten()) {
+    root_->UpdateLayout();
+    return;
+  }
+  if (needs_layout_[0])
+    MeasureInParallel();
+
+  size_t iterations = 0;
+
+  for (; needs_layout_[0] && (iterations < kMaxLayoutIterations);
+       ++iterations) {
+    // Copied, since the stored size changes during the layout
+    const Size size = sizes_[0];
+
+    SetSize(0, size);
+  }
+
+  const bool converged = !needs_layout_[0];
+
+  WriteBack();
+  if (Layout::monitor_ != NULL)
+    Layout::monitor_->PassFinished(root_, iterations, converged);
+}
+
+bool FlatLayout::Flatten() {
+  layouts_.clear();
+  kinds_.clear();
+  parents_.clear();
+  first_children_.clear();
+  child_counts_.clear();
+  flags_.clear();
+  h_sizes_.clear();
+  v_sizes_.clear();
+  aligns_.clear();
+  explicit_sizes_.clear();
+  width_groups_.clear();
+  height_groups_.clear();
+  paddings_.clear();
+  baselines_.clear();
+  sizes_.clear();
+  locations_.clear();
+  directions_.clear();
+  stream_aligns_.clear();
+  margins_.clear();
+  cached_min_sizes_.clear();
+  min_sizes_valid_.clear();
+  needs_layout_.clear();
+  width_names_.clear();
+  height_names_.clear();
+  width_ids_.Clear();
+  height_ids_.Clear();
+  indices_.Clear();
+
+  if (!AddNodes()) {
+    layouts_.clear();
+    return false;
+  }
+
+  // Invalidations that happen while the arrays are being laid out, such as
+  // from a native object whose size was set, are picked up by WriteBack.
+  for (size_t node = 0; node < layouts_.size(); ++node)
+    if (IsContainer(node))
+      static_cast<LayoutContainer*>(layouts_[node])->needs_layout_ = false;
+  for (size_t i = 0; i < width_names_.size(); ++i)
+    if (width_names_[i].source != NULL)
+      width_names_[i].source->valid = true;
+  for (size_t i = 0; i < height_names_.size(); ++i)
+    if (height_names_[i].source != NULL)
+      height_names_[i].source->valid = true;
+  return true;
+}
+
+bool FlatLayout::AddNodes() {
+  Entity* const root_entity = root_->entity_;
+
+  if ((root_entity == NULL) || (root_entity->GetParent() != NULL) ||
+      (root_->GetFlatKind() == Layout::kFlatLeaf))
+    return false;
+  has_size_groups_ = root_entity->GetSizeGroups() != NULL;
+  if (!AddNode(root_, -1))
+    return false;
+
+  // Adding each container's children as it is reached keeps them together.
+  for (uint32_t node = 0; node < layouts_.size(); ++node) {
+    Entity* const entity = layouts_[node]->entity_;
+
+    first_children_[node] = layouts_.size();
+    for (size_t i = 0; i < entity->ChildrenCount(); ++i) {
+      Layout* const child = entity->ChildAt(i)->GetLayout();
+
+      if (child == NULL) {
+        // LayoutContainer expects the first child to have a layout object.
+        if ((i == 0) && IsContainer(node) &&
+            (kinds_[node] != Layout::kFlatMultipanel))
+          return false;
+        continue;
+      }
+      // Only containers lay out their children.
+      if (!IsContainer(node) || !AddNode(child, node))
+        return false;
+    }
+    child_counts_[node] = layouts_.size() - first_children_[node];
+  }
+  return AddNameGroupMembers(&width_names_) &&
+      AddNameGroupMembers(&height_names_);
+}
+
+bool FlatLayout::AddNode(Layout *layout, int32_t parent) {
+  const Layout::FlatKind kind = layout->GetFlatKind();
+
+  if (kind == Layout::kFlatUnsupported)
+    return false;
+
+  Entity* const entity = layout->entity_;
+  SizeGroups* const size_groups = entity->GetSizeGroups();
+  uint8_t flags = 0;
+
+  if (layout->in_layout_)
+    flags |= kFlagInLayout;
+  if (entity->ChildrenCount() != 0)
+    flags |= kFlagHasEntities;
+  if ((kind == Layout::kFlatGroup) || (kind == Layout::kFlatMultipanel) ||
+      ((kind != Layout::kFlatLeaf) && (entity->GetNative() != NULL)))
+    flags |= kFlagKeepsSize;
+
+  indices_.Insert(layout, layouts_.size());
+  layouts_.push_back(layout);
+  kinds_.push_back(kind);
+  parents_.push_back(parent);
+  first_children_.push_back(0);
+  child_counts_.push_back(0);
+  flags_.push_back(flags);
+  h_sizes_.push_back(layout->h_size_);
+  v_sizes_.push_back(layout->v_size_);
+  aligns_.push_back(layout->align_);
+  explicit_sizes_.push_back(
+      ((layout->h_size_ == kSizeExplicit) ||
+       (layout->v_size_ == kSizeExplicit)) ?
+          layout->CalculateExplicitSize() : Size());
+  width_groups_.push_back(AddNameGroup(
+      &width_names_, &width_ids_,
+      (size_groups == NULL) ? NULL : &size_groups->widths_,
+      layout->width_name_));
+  height_groups_.push_back(AddNameGroup(
+      &height_names_, &height_ids_,
+      (size_groups == NULL) ? NULL : &size_groups->heights_,
+      layout->height_name_));
+  paddings_.push_back(layout->GetPadding());
+  // Baselines are only used for aligning rows.
+  baselines_.push_back(
+      ((parent >= 0) && (directions_[parent] == Layout::kLayoutRow)) ?
+          layout->GetBaseline() : 0);
+  sizes_.push_back(layout->GetSize());
+  locations_.push_back(layout->GetLocation());
+
+  if (kind == Layout::kFlatLeaf) {
+    directions_.push_back(Layout::kLayoutRow);
+    stream_aligns_.push_back(kAlignStart);
+    margins_.push_back(Spacing());
+    cached_min_sizes_.push_back(Size());
+    min_sizes_valid_.push_back(false);
+    needs_layout_.push_back(false);
+  } else {
+    const LayoutContainer* const container =
+        static_cast<LayoutContainer*>(layout);
+
+    directions_.push_back(container->direction_);
+    stream_aligns_.push_back(container->stream_align_);
+    margins_.push_back(((flags & kFlagHasEntities) != 0) ?
+        container->GetMargins() : Spacing());
+    cached_min_sizes_.push_back(container->cached_min_size_);
+    min_sizes_valid_.push_back(container->min_size_valid_);
+    needs_layout_.push_back(container->needs_layout_);
+  }
+  return true;
+}
+
+int32_t FlatLayout::AddNameGroup(
+    Array<NameGroup> *groups, NameGroupMap *ids,
+    SizeGroups::GroupMap *sources, const String &name) {
+  if (name.IsEmpty())
+    return kNoGroup;
+
+  const int32_t *id = ids->Find(name);
+
+  if (id != NULL)
+    return *id;
+
+  NameGroup group;
+
+  if (sources != NULL) {
+    group.source = sources->Find(name);
+    if (group.source != NULL) {
+      group.size = group.source->size;
+      group.valid = group.source->valid;
+    }
+  }
+  groups->push_back(group);
+  ids->Insert(name, groups->size() - 1);
+  return groups->size() - 1;
+}
+
+bool FlatLayout::AddNameGroupMembers(Array<NameGroup> *groups) {
+  for (size_t i = 0; i < groups->size(); ++i) {
+    NameGroup &group = (*groups)[i];
+
+    if (group.source == NULL)
+      continue;
+    for (size_t j = 0; j < group.source->members.size(); ++j) {
+      const uint32_t *index = indices_.Find(group.source->members[j]);
+
+      // A member outside the hierarchy would need the original algorithm.
+      if (index == NULL)
+        return false;
+      group.members.push_back(*index);
+    }
+  }
+  return true;
+}
+
+void FlatLayout::WriteBack() {
+  for (size_t node = 0; node < layouts_.size(); ++node) {
+    Layout* const layout = layouts_[node];
+
+    if (IsContainer(node)) {
+      LayoutContainer* const container = static_cast<LayoutContainer*>(layout);
+
+      if (container->needs_layout_) {  // Invalidated during the layout
+        needs_layout_[node] = true;
+        min_sizes_valid_[node] = false;
+      }
+      container->cached_min_size_ = cached_min_sizes_[node];
+      container->min_size_valid_ = min_sizes_valid_[node];
+      container->needs_layout_ = needs_layout_[node];
+      // The children may have been measured again.
+      container->resize_items_valid_ = false;
+      if ((kinds_[node] == Layout::kFlatGroup) ||
+          (kinds_[node] == Layout::kFlatMultipanel))
+        static_cast<Group*>(layout)->min_padding_ = paddings_[node];
+      if (((flags_[node] & kFlagKeepsSize) != 0) &&
+          (sizes_[node] != container->GetSize()))
+        container->SetSizeImp(sizes_[node]);
+    }
+    // Parents come first, so a container that moves finds its descendants'
+    // old locations before they are changed.
+    if ((node != 0) && (locations_[node] != layout->GetLocation()))
+      layout->SetLocation(locations_[node]);
+  }
+  for (size_t i = 0; i < width_names_.size(); ++i) {
+    SizeGroups::Group* const source = width_names_[i].source;
+
+    if ((source != NULL) && source->valid) {
+      source->size = width_names_[i].size;
+      source->valid = width_names_[i].valid;
+    }
+  }
+  for (size_t i = 0; i < height_names_.size(); ++i) {
+    SizeGroups::Group* const source = height_names_[i].source;
+
+    if ((source != NULL) && source->valid) {
+      source->size = height_names_[i].size;
+      source->valid = height_names_[i].valid;
+    }
+  }
+}
+
+void FlatLayout::MeasureInParallel() {
+  if ((thread_pool_ == NULL) || (thread_pool_->ThreadCount() == 0) ||
+      (layouts_.size() < parallel_threshold_ * 2))
+    return;
+
+  // Children come after their parents, so going backward finishes each
+  // subtree before its parent is reached.
+  subtree_sizes_.assign(layouts_.size(), 1);
+  subtrees_named_.assign(layouts_.size(), 0);
+  for (uint32_t node = layouts_.size() - 1; node > 0; --node) {
+    if ((width_groups_[node] != kNoGroup) ||
+        (height_groups_[node] != kNoGroup))
+      subtrees_named_[node] = 1;
+    subtree_sizes_[parents_[node]] += subtree_sizes_[node];
+    subtrees_named_[parents_[node]] |= subtrees_named_[node];
+  }
+
+  Array<uint32_t> subtrees;
+
+  FindParallelSubtrees(0, &subtrees);
+  if (subtrees.size() < 2)
+    return;
+
+  // Each subtree's minimum size depends only on the objects inside it, so
+  // measuring it early gives the same result as the serial pass would, and
+  // the serial pass then finds it in the cache.
+  Array<MeasureTask> tasks;
+  Array<ThreadPool::Task*> task_pointers;
+
+  tasks.reserve(subtrees.size());
+  for (size_t i = 0; i < subtrees.size(); ++i) {
+    tasks.push_back(MeasureTask(this, subtrees[i]));
+    task_pointers.push_back(&tasks.back());
+  }
+  thread_pool_->Run(task_pointers);
+}
+
+void FlatLayout::FindParallelSubtrees(
+    uint32_t node, Array<uint32_t> *subtrees) {
+  if ((subtree_sizes_[node] < parallel_threshold_) || !IsContainer(node))
+    return;
+
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  bool split = false;
+
+  for (uint32_t child = first_children_[node]; child < end; ++child)
+    if (subtree_sizes_[child] >= parallel_threshold_)
+      split = true;
+  // A Multipanel doesn't cache its minimum size, and name groups are shared
+  // between subtrees.
+  if (!split && !subtrees_named_[node] &&
+      (kinds_[node] != Layout::kFlatMultipanel)) {
+    if (!min_sizes_valid_[node])
+      subtrees->push_back(node);
+    return;
+  }
+  for (uint32_t child = first_children_[node]; child < end; ++child)
+    FindParallelSubtrees(child, subtrees);
+}
+
+Size FlatLayout::GetMinimumSize(uint32_t node) {
+  return EnforceExplicitSize(node, CalculateMinimumSize(node));
+}
+
+Size FlatLayout::CalculateMinimumSize(uint32_t node) {
+  switch (kinds_[node]) {
+    case Layout::kFlatContainer:
+    case Layout::kFlatGroup:
+      return ContainerMinimumSize(node);
+    case Layout::kFlatBordered:
+      return BorderedMinimumSize(node);
+    case Layout::kFlatMultipanel:
+      return MultipanelMinimumSize(node);
+    default:
+      return layouts_[node]->CalculateMinimumSize();
+  }
+}
+
+Size FlatLayout::EnforceExplicitSize(uint32_t node, const Size &size) {
+  Size result = size;
+
+  if (width_groups_[node] != kNoGroup)
+    result.width = GetNameSize(
+        &width_names_, Layout::kDimensionWidth, width_groups_[node]);
+  else if (h_sizes_[node] == kSizeExplicit)
+    result.width = std::max(size.width, explicit_sizes_[node].width);
+  if (height_groups_[node] != kNoGroup)
+    result.height = GetNameSize(
+        &height_names_, Layout::kDimensionHeight, height_groups_[node]);
+  else if (v_sizes_[node] == kSizeExplicit)
+    result.height = std::max(size.height, explicit_sizes_[node].height);
+  return result;
+}
+
+void FlatLayout::SetSize(uint32_t node, const Size &size) {
+  if (!IsContainer(node)) {
+    layouts_[node]->SetSize(size);
+    sizes_[node] = layouts_[node]->GetSize();
+    return;
+  }
+  if (needs_layout_[node] || (size != sizes_[node])) {
+    Size new_size;
+    uint32_t extra = 0;
+
+    needs_layout_[node] = false;
+    if (kinds_[node] == Layout::kFlatMultipanel) {
+      SetMultipanelSizes(node, size, &new_size);
+      ArrangeMultipanel(node);
+    } else {
+      SetObjectSizes(node, size, &new_size, &extra);
+      ArrangeObjects(node, new_size, extra);
+    }
+  }
+  if (kinds_[node] == Layout::kFlatGroup)
+    CalculateGroupPadding(node);
+  else if (kinds_[node] == Layout::kFlatMultipanel)
+    CalculateMultipanelPadding(node);
+}
+
+void FlatLayout::InvalidateLayout(uint32_t node) {
+  if (IsContainer(node)) {
+    min_sizes_valid_[node] = false;
+    needs_layout_[node] = true;
+  } else {
+    layouts_[node]->measurement_valid_ = false;
+  }
+  if (has_size_groups_) {
+    if (width_groups_[node] != kNoGroup)
+      InvalidateNameGroup(&width_names_, width_groups_[node]);
+    if (height_groups_[node] != kNoGroup)
+      InvalidateNameGroup(&height_names_, height_groups_[node]);
+  }
+  if (parents_[node] >= 0)
+    InvalidateLayout(parents_[node]);
+}
+
+Size FlatLayout::ContainerMinimumSize(uint32_t node) {
+  if (min_sizes_valid_[node])
+    return cached_min_sizes_[node];
+
+  Size min_size;
+
+  if ((flags_[node] & kFlagHasEntities) != 0) {
+    const uint8_t d = directions_[node];
+    const Spacing &margins = margins_[node];
+    const uint32_t end = first_children_[node] + child_counts_[node];
+    int32_t prev_padding = 0;
+    const int32_t first_padding =
+        StreamBefore(d, GetPadding(first_children_[node]));
+
+    if (first_padding > 0)
+      StreamDim(d, min_size) = -first_padding;
+
+    for (uint32_t child = first_children_[node]; child < end; ++child) {
+      if (!IsInLayout(child))
+        continue;
+
+      const Size child_min = GetMinimumSize(child);
+      const Spacing child_pad = GetPadding(child);
+
+      StreamDim(d, min_size) += StreamDim(d, child_min);
+      if ((prev_padding >= 0) && (StreamBefore(d, child_pad) >= 0))
+        StreamDim(d, min_size) +=
+            std::max(prev_padding, StreamBefore(d, child_pad));
+
+      CrossDim(d, min_size) = std::max(
+          CrossDim(d, min_size),
+          CrossDim(d, child_min) +
+              std::max<int32_t>(0, CrossBefore(d, margins)) +
+              std::max<int32_t>(0, CrossAfter(d, margins)));
+      prev_padding = StreamAfter(d, child_pad);
+    }
+  }
+  cached_min_sizes_[node] = min_size;
+  min_sizes_valid_[node] = true;
+  return min_size;
+}
+
+Size FlatLayout::BorderedMinimumSize(uint32_t node) {
+  if (min_sizes_valid_[node])
+    return cached_min_sizes_[node];
+
+  Size min_size = ContainerMinimumSize(node);
+
+  if ((flags_[node] & kFlagHasEntities) != 0) {
+    const uint8_t d = directions_[node];
+
+    StreamDim(d, min_size) +=
+        StreamBefore(d, margins_[node]) + StreamAfter(d, margins_[node]);
+  }
+  cached_min_sizes_[node] = min_size;
+  return min_size;
+}
+
+Size FlatLayout::MultipanelMinimumSize(uint32_t node) {
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  Size min;
+
+  for (uint32_t child = first_children_[node]; child < end; ++child) {
+    const Size child_min = GetMinimumSize(child);
+
+    if (child_min.width > min.width)
+      min.width = child_min.width;
+    if (child_min.height > min.height)
+      min.height = child_min.height;
+  }
+  return min;
+}
+
+void FlatLayout::SetObjectSizes(
+    uint32_t node, const Size &s, Size *new_size, uint32_t *extra) {
+  const uint8_t d = directions_[node];
+  const Spacing &margins = margins_[node];
+  const uint32_t begin = first_children_[node];
+  const uint32_t end = begin + child_counts_[node];
+  unsigned int fill_count = 0;
+  bool layout_valid = false;
+  size_t iterations = 0;
+
+  for (uint32_t child = begin; child < end; ++child)
+    if (IsInLayout(child) &&
+        (((d == Layout::kLayoutRow) ? h_sizes_[child] : v_sizes_[child]) ==
+         kSizeFill))
+      ++fill_count;
+
+  while (!layout_valid && (iterations < kMaxLayoutIterations)) {
+    layout_valid = true;
+    if (!min_sizes_valid_[node]) {
+      const Size min_size = GetMinimumSize(node);
+
+      cached_min_sizes_[node] = min_size;
+      min_sizes_valid_[node] = true;
+    }
+
+    const Size &cached_min_size = cached_min_sizes_[node];
+
+    *new_size = Size(
+        std::max(s.width, cached_min_size.width),
+        std::max(s.height, cached_min_size.height));
+    *extra = StreamDim(d, *new_size) -
+        StreamDim(d, CalculateMinimumSize(node));
+
+    SetSizeImp(node, *new_size);
+
+    const uint32_t fill = (fill_count == 0) ? 0 : (*extra / fill_count);
+    uint32_t remainder  = (fill_count == 0) ? 0 : (*extra % fill_count);
+
+    for (uint32_t child = begin; child < end; ++child) {
+      if (!IsInLayout(child))
+        continue;
+
+      // The maximum size is the same as the minimum for all layout classes.
+      const Size min = GetMinimumSize(child);
+      const int8_t stream_option =
+          (d == Layout::kLayoutRow) ? h_sizes_[child] : v_sizes_[child];
+      const int8_t cross_option =
+          (d == Layout::kLayoutColumn) ? h_sizes_[child] : v_sizes_[child];
+      Size size = sizes_[child];
+
+      if ((cross_option == kSizeFill) || (CrossDim(d, min) == kSizeFill))
+        CrossDim(d, size) = CrossDim(d, *new_size) -
+            (CrossBefore(d, margins)+CrossAfter(d, margins));
+      else
+        CrossDim(d, size) = CrossDim(d, min);
+
+      if ((fill_count != 0) && ((stream_option == kSizeFill) ||
+                                (StreamDim(d, min) == kSizeFill))) {
+        int32_t item_fill = fill + StreamDim(d, min);
+
+        if (remainder > 0) {
+          ++item_fill;
+          --remainder;
+        }
+        StreamDim(d, size) = item_fill;
+      } else {
+        StreamDim(d, size) = StreamDim(d, min);
+      }
+      if ((iterations != 0) && (size == sizes_[child]) &&
+          !NeedsLayout(child))
+        continue;
+      SetSize(child, size);
+      if (GetMinimumSize(child) != min) {
+        layout_valid = false;
+        if (Layout::monitor_ != NULL)
+          Layout::monitor_->LayoutRepeated(layouts_[node], layouts_[child]);
+      }
+    }
+    ++iterations;
+    if (!layout_valid) {
+      min_sizes_valid_[node] = false;
+      CalculateMinimumSize(node);
+    }
+  }
+  if (Layout::monitor_ != NULL)
+    Layout::monitor_->LayoutFinished(layouts_[node], iterations, layout_valid);
+  if (fill_count != 0)
+    *extra = 0;
+}
+
+void FlatLayout::ArrangeObjects(
+    uint32_t node, const Size &new_size, uint32_t extra) {
+  if ((flags_[node] & kFlagHasEntities) == 0)
+    return;
+
+  // Rows are never reversed because LayoutContainer::IsRTL() is always
+  // false.
+  const uint8_t d = directions_[node];
+  const Spacing &margins = margins_[node];
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  int32_t prev_pad = StreamBefore(d, margins);
+  int32_t last_edge = 0;
+
+  switch (stream_aligns_[node]) {
+    case kAlignStart:
+      break;
+    case kAlignCenter:
+      last_edge += extra / 2;
+      break;
+    case kAlignEnd:
+      last_edge += extra;
+      break;
+  }
+
+  bool first = true;
+
+  for (uint32_t child = first_children_[node]; child < end; ++child) {
+    if (!IsInLayout(child))
+      continue;
+
+    const Spacing padding = GetPadding(child);
+    const Size &child_size = sizes_[child];
+    Location &loc = locations_[child];
+    int32_t before = 0;
+
+    if (first)
+      before = StreamBefore(d, margins);
+    else if ((prev_pad >= 0) && (StreamBefore(d, padding) >= 0))
+      before = std::max(StreamBefore(d, padding), prev_pad);
+    StreamLoc(d, loc) = before + last_edge;
+    CrossLoc(d, loc)  = CrossBefore(d, margins);
+    if (aligns_[child] != kAlignStart) {
+      const int32_t cross_extra =
+          CrossDim(d, new_size) - CrossDim(d, child_size) -
+          (CrossBefore(d, margins) + CrossAfter(d, margins));
+
+      if (aligns_[child] == kAlignEnd)
+        CrossLoc(d, loc) += cross_extra;
+      else
+        CrossLoc(d, loc) += cross_extra / 2;
+    }
+    last_edge = StreamLoc(d, loc) + StreamDim(d, child_size);
+    prev_pad = StreamAfter(d, padding);
+    first = false;
+  }
+  AlignBaselines(node);
+}
+
+void FlatLayout::AlignBaselines(uint32_t node) {
+  if (directions_[node] != Layout::kLayoutRow)
+    return;
+
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  int32_t best_items[3] = { -1, -1, -1 };
+  int32_t baselines[3] = { 0, 0, sizes_[node].height };
+  int32_t center_height = 0;
+  uint32_t child;
+
+  for (child = first_children_[node]; child < end; ++child) {
+    if (!IsInLayout(child))
+      continue;
+
+    const int32_t baseline = baselines_[child];
+
+    switch (aligns_[child]) {
+      case kAlignStart:
+        if (baseline > baselines[0]) {
+          baselines[0] = baseline;
+          best_items[0] = child;
+        }
+        break;
+      case kAlignCenter:
+        if (sizes_[child].height > center_height) {
+          center_height = sizes_[child].height;
+          baselines[1] = baseline;
+          best_items[1] = child;
+        }
+        break;
+      case kAlignEnd:
+        if (baseline < baselines[2]) {
+          baselines[2] = baseline;
+          best_items[2] = child;
+        }
+        break;
+    }
+  }
+  for (child = first_children_[node]; child < end; ++child) {
+    if (!IsInLayout(child))
+      continue;
+
+    const int8_t a = aligns_[child];
+
+    if (static_cast<int32_t>(child) == best_items[a])
+      continue;
+    if (baselines_[child] != 0)
+      locations_[child].y += baselines[a] - baselines_[child];
+  }
+}
+
+void FlatLayout::SetMultipanelSizes(
+    uint32_t node, const Size &s, Size *new_size) {
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  bool layout_valid = false;
+  size_t iterations = 0;
+
+  while (!layout_valid && (iterations < kMaxLayoutIterations)) {
+    layout_valid = true;
+    if (!min_sizes_valid_[node]) {
+      const Size min_size = GetMinimumSize(node);
+
+      cached_min_sizes_[node] = min_size;
+      min_sizes_valid_[node] = true;
+    }
+    *new_size = Size(
+        std::max(s.width, cached_min_sizes_[node].width),
+        std::max(s.height, cached_min_sizes_[node].height));
+    SetSizeImp(node, *new_size);
+
+    for (uint32_t child = first_children_[node]; child < end; ++child) {
+      if (!IsInLayout(child))
+        continue;
+
+      const Size min = GetMinimumSize(child);
+      Size child_size = min;
+
+      if (h_sizes_[child] == kSizeFill)
+        child_size.width = s.width;
+      if (v_sizes_[child] == kSizeFill)
+        child_size.height = s.height;
+
+      if ((iterations != 0) && (child_size == sizes_[child]) &&
+          !NeedsLayout(child))
+        continue;
+      SetSize(child, child_size);
+      if (GetMinimumSize(child) != min) {
+        layout_valid = false;
+        if (Layout::monitor_ != NULL)
+          Layout::monitor_->LayoutRepeated(layouts_[node], layouts_[child]);
+      }
+    }
+    ++iterations;
+    if (!layout_valid) {
+      min_sizes_valid_[node] = false;
+      CalculateMinimumSize(node);
+    }
+  }
+  if (Layout::monitor_ != NULL)
+    Layout::monitor_->LayoutFinished(layouts_[node], iterations, layout_valid);
+}
+
+void FlatLayout::ArrangeMultipanel(uint32_t node) {
+  Entity* const entity = layouts_[node]->entity_;
+  uint32_t child = first_children_[node];
+  // Extra parens so this isn't parsed as a function
+  const Value location_value((Location()));
+
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i) {
+    if (entity->ChildAt(i)->GetLayout() != NULL)
+      locations_[child++] = Location();
+    else
+      entity->ChildAt(i)->SetProperty(kPropLocation, location_value);
+  }
+}
+
+void FlatLayout::CalculateGroupPadding(uint32_t node) {
+  if ((flags_[node] & kFlagHasEntities) == 0)
+    return;
+
+  const uint8_t d = directions_[node];
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  int32_t front = -1, back = -1;
+  uint32_t child;
+
+  for (child = first_children_[node]; child < end; ++child) {
+    if (IsInLayout(child)) {
+      back = child;
+      if (front < 0)
+        front = child;
+    }
+  }
+  if (back < 0) {  // All children are hidden
+    paddings_[node] = Spacing();
+    return;
+  }
+
+  Spacing new_min_padding;
+
+  StreamBefore(d, new_min_padding) = StreamBefore(d, GetPadding(front));
+  StreamAfter(d, new_min_padding)  = StreamAfter(d, GetPadding(back));
+
+  int32_t &before = CrossBefore(d, new_min_padding);
+  int32_t &after = CrossAfter(d, new_min_padding);
+
+  for (child = first_children_[node]; child < end; ++child) {
+    if (!IsInLayout(child))
+      continue;
+
+    const Spacing &pad  = paddings_[child];
+    const Location &loc = locations_[child];
+    const Size &size    = sizes_[child];
+
+    before = std::max(before, CrossBefore(d, pad) - CrossLoc(d, loc));
+    after  = std::max(after, CrossAfter(d, pad) -
+         (CrossDim(d, sizes_[node]) - (CrossLoc(d, loc) + CrossDim(d, size))));
+  }
+
+  if (new_min_padding != paddings_[node]) {
+    paddings_[node] = new_min_padding;
+    if (parents_[node] >= 0)
+      InvalidateLayout(parents_[node]);
+  }
+}
+
+void FlatLayout::CalculateMultipanelPadding(uint32_t node) {
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  const Size &size = sizes_[node];
+  Spacing new_min_padding;
+
+  for (uint32_t child = first_children_[node]; child < end; ++child) {
+    const Spacing &child_pad = paddings_[child];
+    const Size &child_size = sizes_[child];
+
+    if (child_pad.left > new_min_padding.left)
+      new_min_padding.left = child_pad.left;
+    if (child_pad.top > new_min_padding.top)
+      new_min_padding.top = child_pad.top;
+    if ((child_size.width + child_pad.right) >
+        (size.width + new_min_padding.right))
+      new_min_padding.right = child_size.width + child_pad.right - size.width;
+    if ((child_size.height + child_pad.bottom) >
+        (size.height + new_min_padding.bottom))
+      new_min_padding.bottom =
+          child_size.height + child_pad.bottom - size.height;
+  }
+
+  if (new_min_padding != paddings_[node]) {
+    paddings_[node] = new_min_padding;
+    if (parents_[node] >= 0)
+      InvalidateLayout(parents_[node]);
+  }
+}
+
+uint32_t FlatLayout::GetNameSize(
+    Array<NameGroup> *groups, Layout::Dimension dimension, int32_t group) {
+  if (!has_size_groups_)
+    return FindDimensionForName(0, dimension, group);
+
+  NameGroup &name_group = (*groups)[group];
+
+  if (name_group.source == NULL)
+    return 0;
+  if (!name_group.valid) {
+    // Marked valid first so that a member nested inside another member sees
+    // the partial result instead of recursing.
+    name_group.size = 0;
+    name_group.valid = true;
+    for (size_t i = 0; i < name_group.members.size(); ++i) {
+      const Size member_size = CalculateMinimumSize(name_group.members[i]);
+
+      name_group.size = std::max<uint32_t>(
+          name_group.size, (dimension == Layout::kDimensionWidth) ?
+              member_size.width : member_size.height);
+    }
+  }
+  return name_group.size;
+}
+
+uint32_t FlatLayout::FindDimensionForName(
+    uint32_t node, Layout::Dimension dimension, int32_t group) {
+  if (dimension == Layout::kDimensionWidth) {
+    if (width_groups_[node] == group)
+      return CalculateMinimumSize(node).width;
+  } else {  // kDimensionHeight
+    if (height_groups_[node] == group)
+      return CalculateMinimumSize(node).height;
+  }
+
+  const uint32_t end = first_children_[node] + child_counts_[node];
+  uint32_t max = 0;
+
+  for (uint32_t child = first_children_[node]; child < end; ++child)
+    max = std::max(max, FindDimensionForName(child, dimension, group));
+  return max;
+}
+
+void FlatLayout::InvalidateNameGroup(Array<NameGroup> *groups, int32_t group) {
+  NameGroup &name_group = (*groups)[group];
+
+  // If the group is already invalid, the members' containers have already
+  // been invalidated and have not been laid out since.
+  if ((name_group.source == NULL) || !name_group.valid)
+    return;
+  name_group.valid = false;
+  for (size_t i = 0; i < name_group.members.size(); ++i)
+    if (parents_[name_group.members[i]] >= 0)
+      InvalidateLayout(parents_[name_group.members[i]]);
+}
+
+}  // namespace Diadem
@@ -0,0 +1,193 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_FLATLAYOUT_H_
+#define DIADEM_FLATLAYOUT_H_
+
+#include "Diadem/Layout.h"
+
+namespace Diadem {
+
+class ThreadPool;
+
+// An alternative to laying out a hierarchy through its Layout objects. The
+// layout state is copied into parallel arrays, with each container's
+// children stored next to each other, and the LayoutContainer, Group,
+// BorderedContainer and Multipanel algorithms run over the arrays. The
+// results, including the containers' caches, are then written back to the
+// layout objects, so the geometry is the same as if the root had been laid
+// out directly. Leaf objects are still measured and sized through their own
+// methods, since that is where the native objects are consulted.
+//
+// The arrays are rebuilt for each call, so the hierarchy may change between
+// calls. If it can't be flattened, such as when it has a container type that
+// returns kFlatUnsupported, the call is passed on to the root layout object.
+class FlatLayout {
+ public:
+  // The root must be the layout object of the hierarchy's root entity.
+  explicit FlatLayout(Layout *root)
+      : root_(root), has_size_groups_(false), thread_pool_(NULL),
+        parallel_threshold_(kDefaultParallelThreshold) {}
+
+  // Subtrees with fewer layout objects than this are measured serially.
+  static const size_t kDefaultParallelThreshold = 64;
+
+  // Before laying out, measures large independent subtrees on the pool's
+  // threads, such as the panels of a Multipanel. This is only safe if the
+  // native objects can report their minimum sizes from any thread, and so
+  // is off by default. Subtrees smaller than the threshold, and those with
+  // width or height names, are left for the serial pass. The results are
+  // the same as without the pool.
+  void SetThreadPool(
+      ThreadPool *pool, size_t threshold = kDefaultParallelThreshold) {
+    thread_pool_ = pool;
+    parallel_threshold_ = threshold;
+  }
+
+  // These work like the LayoutContainer methods of the same names.
+  void ResizeToMinimum();
+  void SetSize(const Size &size);
+  void UpdateLayout();
+
+  // The number of layout objects in the arrays after the last call, or 0 if
+  // the hierarchy couldn't be flattened.
+  size_t NodeCount() const { return layouts_.size(); }
+
+ protected:
+  // The shared state of the objects with a given width or height name,
+  // copied from the SizeGroups registry if the root has one.
+  struct NameGroup {
+    NameGroup() : size(0), valid(false), source(NULL) {}
+
+    Array<uint32_t> members;
+    uint32_t size;
+    bool valid;
+    SizeGroups::Group *source;  // From the registry, if any
+  };
+  typedef HashMap<String, int32_t> NameGroupMap;
+
+  enum NodeFlags {
+    kFlagInLayout    = 1 << 0,
+    kFlagKeepsSize   = 1 << 1,  // GetSize returns what was last set
+    kFlagHasEntities = 1 << 2,  // The entity has any children at all
+  };
+
+  static const int32_t kNoGroup = -1;
+
+  class MeasureTask;
+
+  Layout *root_;
+  bool has_size_groups_;
+  ThreadPool *thread_pool_;
+  size_t parallel_threshold_;
+
+  // Node 0 is the root. Each container's children are in the range starting
+  // at first_children_ and are in the same order as the entity's children.
+  Array<Layout*> layouts_;
+  Array<uint8_t> kinds_;
+  Array<int32_t> parents_;
+  Array<uint32_t> first_children_, child_counts_;
+  Array<uint8_t> flags_;
+  Array<int8_t> h_sizes_, v_sizes_, aligns_;
+  Array<Size> explicit_sizes_;
+  Array<int32_t> width_groups_, height_groups_;
+  Array<Spacing> paddings_;   // Group padding, or the fixed padding
+  Array<int32_t> baselines_;
+  Array<Size> sizes_;
+  Array<Location> locations_;
+
+  // Container state, also indexed by node but unused for leaves.
+  Array<uint8_t> directions_, stream_aligns_;
+  Array<Spacing> margins_;
+  Array<Size> cached_min_sizes_;
+  Array<uint8_t> min_sizes_valid_, needs_layout_;
+
+  Array<NameGroup> width_names_, height_names_;
+  NameGroupMap width_ids_, height_ids_;
+  HashMap<Layout*, uint32_t> indices_;
+
+  // Used for choosing subtrees to measure in parallel.
+  Array<uint32_t> subtree_sizes_;
+  Array<uint8_t> subtrees_named_;
+
+  // Copies the hierarchy into the arrays. Returns false, leaving the arrays
+  // empty, if it can't be flattened.
+  bool Flatten();
+  bool AddNodes();
+  // Appends the layout object's state. Returns false if it can't be
+  // flattened.
+  bool AddNode(Layout *layout, int32_t parent);
+  // Returns the index of the name's group, adding it if necessary.
+  int32_t AddNameGroup(
+      Array<NameGroup> *groups, NameGroupMap *ids,
+      SizeGroups::GroupMap *sources, const String &name);
+  bool AddNameGroupMembers(Array<NameGroup> *groups);
+  // Copies the results back to the layout objects.
+  void WriteBack();
+
+  // Calculates the minimum sizes of large subtrees using the thread pool.
+  void MeasureInParallel();
+  // Adds the subtrees to measure in parallel: containers at least as big as
+  // the threshold whose children are all smaller, and whose minimum sizes
+  // don't depend on objects outside them.
+  void FindParallelSubtrees(uint32_t node, Array<uint32_t> *subtrees);
+
+  // Per-node versions of the Layout methods.
+  Size GetMinimumSize(uint32_t node);
+  Size CalculateMinimumSize(uint32_t node);
+  Size EnforceExplicitSize(uint32_t node, const Size &size);
+  void SetSize(uint32_t node, const Size &size);
+  void InvalidateLayout(uint32_t node);
+
+  // Versions of the container algorithms.
+  Size ContainerMinimumSize(uint32_t node);
+  Size BorderedMinimumSize(uint32_t node);
+  Size MultipanelMinimumSize(uint32_t node);
+  void SetObjectSizes(
+      uint32_t node, const Size &s, Size *new_size, uint32_t *extra);
+  void ArrangeObjects(uint32_t node, const Size &new_size, uint32_t extra);
+  void AlignBaselines(uint32_t node);
+  void SetMultipanelSizes(uint32_t node, const Size &s, Size *new_size);
+  void ArrangeMultipanel(uint32_t node);
+  void CalculateGroupPadding(uint32_t node);
+  void CalculateMultipanelPadding(uint32_t node);
+
+  // Width and height names.
+  uint32_t GetNameSize(
+      Array<NameGroup> *groups, Layout::Dimension dimension, int32_t group);
+  uint32_t FindDimensionForName(
+      uint32_t node, Layout::Dimension dimension, int32_t group);
+  void InvalidateNameGroup(Array<NameGroup> *groups, int32_t group);
+
+  bool IsContainer(uint32_t node) const
+    { return kinds_[node] != Layout::kFlatLeaf; }
+  bool IsInLayout(uint32_t node) const
+    { return (flags_[node] & kFlagInLayout) != 0; }
+  bool NeedsLayout(uint32_t node) const
+    { return IsContainer(node) && needs_layout_[node]; }
+  Spacing GetPadding(uint32_t node) const { return paddings_[node]; }
+  void SetSizeImp(uint32_t node, const Size &size) {
+    if ((flags_[node] & kFlagKeepsSize) != 0)
+      sizes_[node] = size;
+  }
+
+ private:
+  // Disallow copying
+  FlatLayout(const FlatLayout&);
+  void operator=(const FlatLayout&);
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_FLATLAYOUT_H_
@@ -60,7 +60,7 @@ void LabelGroup::InitializeProperties(
 }
 
 bool LabelGroup::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     label_->SetProperty(kPropText, value);
     return true;
   }
@@ -77,7 +77,7 @@ void LabelGroup::Finalize() {
 }
 
 bool ColumnLabelLayout::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropColumnWidthName) == 0) {
+  if (name == kPropColumnWidthName) {
     label_group_->GetLabel()->SetProperty(kPropWidthName, value);
     return true;
   }
@@ -64,11 +64,14 @@ const StringConstant
     kDirectionNameRow    = "row",
     kDirectionNameColumn = "column";
 
+MeasurementCounts Layout::measurement_counts_;
+LayoutMonitor *Layout::monitor_ = NULL;
+
 // Height or width may be specified as fit, fill or default, or an explicit
 // size. Fit is the smallest size that will fit the object's contents. Fill
 // expands to take up any extra space in the parent container. Default will
 // vary depending on the object type.
-static bool ParseSizeOption(const char *c, SizeOption *size) {
+bool ParseSizeOption(const char *c, SizeOption *size) {
   const char* strings[3] = {
       kSizeNameDefault, kSizeNameFit, kSizeNameFill };
   const SizeOption options[3] = { kSizeDefault, kSizeFit, kSizeFill };
@@ -103,7 +106,7 @@ static AlignOption ReverseAlignment(AlignOption a) {
 }
 
 void Layout::InitializeProperties(const PropertyMap &properties) {
-  const Array<String> keys = properties.AllKeys();
+  const Array<PropertyName> keys = properties.AllKeys();
 
   for (size_t i = 0; i < keys.size(); ++i)
     SetProperty(keys[i], properties[keys[i]]);
@@ -124,6 +127,15 @@ const Layout* Layout::GetLayoutParent() const {
 void Layout::InvalidateLayout() {
   Layout *parent = GetLayoutParent();
 
+  measurement_valid_ = false;
+  // Before the layout is attached, SizeGroups::AddTree picks it up later.
+  if ((entity_ != NULL) &&
+      (!width_name_.IsEmpty() || !height_name_.IsEmpty())) {
+    SizeGroups* const size_groups = entity_->GetSizeGroups();
+
+    if (size_groups != NULL)
+      size_groups->MemberChanged(this);
+  }
   if (parent != NULL)
     parent->InvalidateLayout();
 }
@@ -136,90 +148,206 @@ Layout::LayoutDirection Layout::GetDirection() const {
   return parent->GetDirection();
 }
 
+const PropertyTable<Layout>& Layout::Properties() {
+  static const PropertyTable<Layout> table = PropertyTable<Layout>()
+      .Add(kPropInLayout,
+           &Layout::SetInLayoutProperty, &Layout::GetInLayoutProperty)
+      .Add(kPropVisible,
+           &Layout::SetVisibleProperty, &Layout::GetVisibleProperty)
+      .Add(kPropFullyVisible, NULL, &Layout::GetFullyVisibleProperty)
+      .Add(kPropWidthOption,
+           &Layout::SetWidthOptionProperty, &Layout::GetWidthOptionProperty)
+      .Add(kPropHeightOption, &Layout::SetHeightOptionProperty)
+      .Add(kPropAlign, &Layout::SetAlignProperty)
+      .Add(kPropLocation,
+           &Layout::SetLocationProperty, &Layout::GetLocationProperty)
+      .Add(kPropWidthName, &Layout::SetWidthNameProperty)
+      .Add(kPropHeightName, &Layout::SetHeightNameProperty)
+      .Add(kPropText, &Layout::SetMeasuredProperty)
+      .Add(kPropUISize, &Layout::SetMeasuredProperty)
+      .Add(kPropStyle, &Layout::SetMeasuredProperty)
+      .Add(kPropFile, &Layout::SetMeasuredProperty)
+      .Add(kPropTicks, &Layout::SetMeasuredProperty);
+
+  return table;
+}
+
 bool Layout::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropInLayout) == 0) {
-    in_layout_ = value.Coerce<bool>();
-    entity_->SetProperty(kPropVisible, in_layout_);
-    InvalidateLayout();
-    return true;
-  }
-  if (strcmp(name, kPropVisible) == 0) {
-    if (AreAncestorsVisible()) {
-      return false;  // Allow native to handle it
-    } else {
-      latent_visibility_ = value.Coerce<bool>();
-      return true;
-    }
-  }
-  if (strcmp(name, kPropWidthOption) == 0) {
-    const String width_string = value.Coerce<String>();
+  const PropertyTable<Layout>::Setter setter = Properties().GetSetter(name);
 
-    if (!ParseSizeOption(width_string, &h_size_)) {
-      explicit_size_.ParseWidth(width_string);
-      h_size_ = kSizeExplicit;
-    }
-    return true;
-  }
-  if (strcmp(name, kPropHeightOption) == 0) {
-    const String height_string = value.Coerce<String>();
+  if (setter != NULL)
+    return (this->*setter)(value);
+  return false;
+}
 
-    if (!ParseSizeOption(height_string, &v_size_)) {
-      explicit_size_.ParseHeight(height_string);
-      v_size_ = kSizeExplicit;
-    }
-    return true;
-  }
-  if (strcmp(name, kPropAlign) == 0) {
-    const String align_string = value.Coerce<String>();
-
-    if (align_string == kAlignNameStart)
-      align_ = kAlignStart;
-    else if (align_string == kAlignNameCenter)
-      align_ = kAlignCenter;
-    else if (align_string == kAlignNameEnd)
-      align_ = kAlignEnd;
+Value Layout::GetProperty(PropertyName name) const {
+  const PropertyTable<Layout>::Getter getter = Properties().GetGetter(name);
+
+  if (getter != NULL)
+    return (this->*getter)();
+  return Value();
+}
+
+bool Layout::SetInLayoutProperty(const Value &value) {
+  in_layout_ = value.Coerce<bool>();
+  entity_->SetProperty(kPropVisible, in_layout_);
+  InvalidateLayout();
+  return true;
+}
+
+bool Layout::SetVisibleProperty(const Value &value) {
+  if (AreAncestorsVisible()) {
+    return false;  // Allow native to handle it
+  } else {
+    latent_visibility_ = value.Coerce<bool>();
     return true;
   }
-  if (strcmp(name, kPropWidthName) == 0) {
-    width_name_ = value.Coerce<String>();
+}
+
+bool Layout::SetWidthOptionProperty(const Value &value) {
+  const String width_string = value.Coerce<String>();
+
+  if (!ParseSizeOption(width_string, &h_size_)) {
+    explicit_size_.ParseWidth(width_string);
+    h_size_ = kSizeExplicit;
   }
-  if (strcmp(name, kPropHeightName) == 0) {
-    height_name_ = value.Coerce<String>();
+  return true;
+}
+
+bool Layout::SetHeightOptionProperty(const Value &value) {
+  const String height_string = value.Coerce<String>();
+
+  if (!ParseSizeOption(height_string, &v_size_)) {
+    explicit_size_.ParseHeight(height_string);
+    v_size_ = kSizeExplicit;
   }
+  return true;
+}
+
+bool Layout::SetAlignProperty(const Value &value) {
+  const String align_string = value.Coerce<String>();
+
+  if (align_string == kAlignNameStart)
+    align_ = kAlignStart;
+  else if (align_string == kAlignNameCenter)
+    align_ = kAlignCenter;
+  else if (align_string == kAlignNameEnd)
+    align_ = kAlignEnd;
+  return true;
+}
+
+// The width and height names are recorded, but the property is not
+// considered handled so that it still gets passed on.
+bool Layout::SetWidthNameProperty(const Value &value) {
+  SetWidthName(value.Coerce<String>());
   return false;
 }
 
-Value Layout::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropInLayout) == 0) {
-    return Value(in_layout_);
-  }
-  if (strcmp(name, kPropVisible) == 0) {
-    if (!AreAncestorsVisible())
-      return latent_visibility_;
-    return Value();  // Pass on to Native.
-  }
-  if (strcmp(name, kPropFullyVisible) == 0) {
-    const Value visible = entity_->GetProperty(kPropVisible);
+bool Layout::SetHeightNameProperty(const Value &value) {
+  SetHeightName(value.Coerce<String>());
+  return false;
+}
 
-    if (!visible.IsValid() || !visible.Coerce<bool>())
-      return false;
-    return AreAncestorsVisible();
-  }
-  if (strcmp(name, kPropWidthOption) == 0) {
-    return Value(static_cast<int>(h_size_));
+// Properties such as text may change the minimum size, but the native object
+// still needs to handle them.
+bool Layout::SetMeasuredProperty(const Value &value) {
+  InvalidateLayout();
+  return false;
+}
+
+// The location of a top-level object is left to the native object.
+bool Layout::SetLocationProperty(const Value &value) {
+  if (entity_->GetParent() == NULL)
+    return false;
+  SetLocation(value.Coerce<Location>());
+  return true;
+}
+
+Value Layout::GetInLayoutProperty() const {
+  return Value(in_layout_);
+}
+
+Value Layout::GetVisibleProperty() const {
+  if (!AreAncestorsVisible())
+    return latent_visibility_;
+  return Value();  // Pass on to Native.
+}
+
+Value Layout::GetFullyVisibleProperty() const {
+  const Value visible = entity_->GetProperty(kPropVisible);
+
+  if (!visible.IsValid() || !visible.Coerce<bool>())
+    return false;
+  return AreAncestorsVisible();
+}
+
+Value Layout::GetWidthOptionProperty() const {
+  return Value(static_cast<int>(h_size_));
+}
+
+Value Layout::GetLocationProperty() const {
+  if (entity_->GetParent() == NULL)
+    return Value();
+  return GetLocation();
+}
+
+void Layout::AncestorsChanged() {
+  metrics_ = NULL;
+  ancestors_visible_valid_ = false;
+  // The stored location is relative to the old parent.
+  location_known_ = false;
+  descendant_locations_known_ = false;
+  for (Entity *entity = entity_->GetParent(); entity != NULL;
+       entity = entity->GetParent()) {
+    Layout* const layout = entity->GetLayout();
+
+    if (layout == NULL)
+      continue;
+    if (!layout->descendant_locations_known_)
+      break;
+    layout->descendant_locations_known_ = false;
   }
-  return Value();
 }
 
 bool Layout::AreAncestorsVisible() const {
-  for (Entity *entity = entity_->GetParent(); entity != NULL;
+  if (ancestors_visible_valid_)
+    return ancestors_visible_;
+
+  // Only the parents up to the nearest one with a layout are checked. That
+  // layout's own cache covers the rest, and it is always filled in so that
+  // a valid cache never sits below an invalid one.
+  ancestors_visible_ = true;
+  for (const Entity *entity = entity_->GetParent(); entity != NULL;
        entity = entity->GetParent()) {
     const Value visible = entity->GetProperty(kPropVisible);
 
     if (!visible.IsValid() || !visible.Coerce<bool>())
-      return false;
+      ancestors_visible_ = false;
+    if (entity->GetLayout() != NULL) {
+      if (!entity->GetLayout()->AreAncestorsVisible())
+        ancestors_visible_ = false;
+      break;
+    }
   }
-  return true;
+  ancestors_visible_valid_ = true;
+  return ancestors_visible_;
+}
+
+void Layout::InvalidateDescendantVisibility() {
+  for (size_t i = 0; i < entity_->ChildrenCount(); ++i)
+    InvalidateAncestorVisibility(entity_->ChildAt(i));
+}
+
+void Layout::InvalidateAncestorVisibility(Entity *entity) {
+  Layout* const layout = entity->GetLayout();
+
+  if (layout != NULL) {
+    if (!layout->ancestors_visible_valid_)
+      return;
+    layout->ancestors_visible_valid_ = false;
+  }
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    InvalidateAncestorVisibility(entity->ChildAt(i));
 }
 
 Location Layout::GetViewLocation() const {
@@ -238,66 +366,100 @@ Location Layout::GetViewLocation() const {
   return GetLocation();
 }
 
-void Layout::ParentLocationChanged(const Location &offset) {
-  if (offset != Location()) {
-    const Value old_location = entity_->GetProperty(kPropLocation);
+Size Layout::CalculateMinimumSize() const {
+  const int32_t width = GetSize().width;
 
-    if (old_location.IsValid())
-      entity_->SetProperty(
-          kPropLocation, old_location.Coerce<Location>() + offset);
+  if (measurement_valid_ && (width == measured_width_)) {
+    AtomicAdd<size_t>(&measurement_counts_.cached, 1);
+    return measured_size_;
   }
-}
-
-Size Layout::CalculateMinimumSize() const {
-  return entity_->GetProperty(kPropMinimumSize).Coerce<Size>();
+  // The native object may need its new size to measure itself, so a size
+  // held by a GeometryBatch is applied now.
+  if (size_pending_) {
+    entity_->SetNativeProperty(kPropSize, pending_size_);
+    size_pending_ = false;
+  }
+  AtomicAdd<size_t>(&measurement_counts_.measured, 1);
+  measured_size_ = entity_->GetProperty(kPropMinimumSize).Coerce<Size>();
+  measured_width_ = width;
+  measurement_valid_ = true;
+  return measured_size_;
 }
 
 Size Layout::EnforceExplicitSize(const Size &size) const {
   Size result = size;
-  const PlatformMetrics &metrics = GetPlatformMetrics();
 
-  if (!width_name_.IsEmpty()) {
+  if (!width_name_.IsEmpty())
     result.width = FindWidthForName();
-  } else if (h_size_ == kSizeExplicit) {
-    uint32_t h_multiplier = 1;
-
-    switch (explicit_size_.width_units_) {
-      case kUnitEms:
-        h_multiplier = metrics.em_size;
-        break;
-      case kUnitIndent:
-        h_multiplier = metrics.indent_size;
-        break;
-      default:
-        break;
-    }
-    result.width =
-        std::max<int32_t>(size.width, explicit_size_.width_ * h_multiplier);
-  }
-  if (!height_name_.IsEmpty()) {
+  else if (h_size_ == kSizeExplicit)
+    result.width = std::max<int32_t>(size.width, CalculateExplicitSize().width);
+  if (!height_name_.IsEmpty())
     result.height = FindHeightForName();
-  } else if (v_size_ == kSizeExplicit) {
-    uint32_t v_multiplier = 1;
-
-    switch (explicit_size_.width_units_) {
-      case kUnitEms:
-        v_multiplier = metrics.em_size;
-        break;
-      case kUnitIndent:
-        v_multiplier = metrics.indent_size;
-        break;
-      case kUnitLines:
-        v_multiplier = metrics.line_height;
-      default:
-        break;
-    }
+  else if (v_size_ == kSizeExplicit)
     result.height =
-        std::max<int32_t>(size.height, explicit_size_.height_ * v_multiplier);
-  }
+        std::max<int32_t>(size.height, CalculateExplicitSize().height);
   return result;
 }
 
+Size Layout::CalculateExplicitSize() const {
+  const PlatformMetrics &metrics = GetPlatformMetrics();
+  uint32_t h_multiplier = 1, v_multiplier = 1;
+
+  switch (explicit_size_.width_units_) {
+    case kUnitEms:
+      h_multiplier = metrics.em_size;
+      break;
+    case kUnitIndent:
+      h_multiplier = metrics.indent_size;
+      break;
+    default:
+      break;
+  }
+  switch (explicit_size_.width_units_) {
+    case kUnitEms:
+      v_multiplier = metrics.em_size;
+      break;
+    case kUnitIndent:
+      v_multiplier = metrics.indent_size;
+      break;
+    case kUnitLines:
+      v_multiplier = metrics.line_height;
+    default:
+      break;
+  }
+  return Size(explicit_size_.width_ * h_multiplier,
+              explicit_size_.height_ * v_multiplier);
+}
+
+void Layout::SetWidthName(const String &name) {
+  SizeGroups* const size_groups =
+      (entity_ == NULL) ? NULL : entity_->GetSizeGroups();
+
+  if (size_groups != NULL)
+    size_groups->Remove(this);
+  width_name_ = name;
+  if (size_groups != NULL)
+    size_groups->Add(this);
+}
+
+void Layout::SetHeightName(const String &name) {
+  SizeGroups* const size_groups =
+      (entity_ == NULL) ? NULL : entity_->GetSizeGroups();
+
+  if (size_groups != NULL)
+    size_groups->Remove(this);
+  height_name_ = name;
+  if (size_groups != NULL)
+    size_groups->Add(this);
+}
+
 uint32_t Layout::FindWidthForName() const {
+  SizeGroups* const size_groups =
+      const_cast<Entity*>(entity_)->GetSizeGroups();
+
+  if (size_groups != NULL)
+    return size_groups->GetWidth(width_name_);
+
   const Entity *root = entity_;
 
   for (; root->GetParent() != NULL; root = root->GetParent()) {
@@ -309,6 +471,12 @@ uint32_t Layout::FindWidthForName() const {
 }
 
 uint32_t Layout::FindHeightForName() const {
+  SizeGroups* const size_groups =
+      const_cast<Entity*>(entity_)->GetSizeGroups();
+
+  if (size_groups != NULL)
+    return size_groups->GetHeight(height_name_);
+
   const Entity *root = entity_;
 
   for (; root->GetParent() != NULL; root = root->GetParent()) {
@@ -316,7 +484,7 @@ uint32_t Layout::FindHeightForName() const {
     DASSERT(root->GetLayout() != NULL);
   }
   return root->GetLayout()->FindDimensionForName(
-      kDimensionHeight, width_name_);
+      kDimensionHeight, height_name_);
 }
 
 uint32_t Layout::FindDimensionForName(
@@ -341,78 +509,219 @@ uint32_t Layout::FindDimensionForName(
   return max;
 }
 
+void Layout::SetNativeSize(const Size &size) {
+  GeometryBatch* const batch = GetGeometryBatch();
+
+  if ((batch == NULL) || (entity_->GetNative() == NULL)) {
+    entity_->SetNativeProperty(kPropSize, size);
+    return;
+  }
+  pending_size_ = size;
+  size_pending_ = true;
+  if (!in_geometry_batch_) {
+    batch->Add(this);
+    in_geometry_batch_ = true;
+  }
+}
+
+Size Layout::GetNativeSize() const {
+  if (size_pending_)
+    return pending_size_;
+  return entity_->GetNativeProperty(kPropSize).Coerce<Size>();
+}
+
+void Layout::SetNativeLocation(const Location &loc) {
+  GeometryBatch* const batch = GetGeometryBatch();
+
+  // A window can be moved by the user, so its location is not kept.
+  location_ = loc;
+  location_known_ = entity_->GetParent() != NULL;
+  if ((batch == NULL) || (entity_->GetNative() == NULL)) {
+    entity_->SetNativeProperty(kPropLocation, loc);
+    return;
+  }
+  location_pending_ = true;
+  if (!in_geometry_batch_) {
+    batch->Add(this);
+    in_geometry_batch_ = true;
+  }
+}
+
+Location Layout::GetNativeLocation() const {
+  if (location_known_ || location_pending_)
+    return location_;
+
+  const Location loc =
+      entity_->GetNativeProperty(kPropLocation).Coerce<Location>();
+
+  if (entity_->GetParent() != NULL) {
+    location_ = loc;
+    location_known_ = true;
+  }
+  return loc;
+}
+
+void Layout::DescendantsMoved() {
+  GeometryBatch* const batch = GetGeometryBatch();
+
+  if (batch == NULL) {
+    CommitDescendantLocations();
+  } else if (!descendants_moved_) {
+    descendants_moved_ = true;
+    batch->AddMoved(this);
+  }
+}
+
+void Layout::CommitDescendantLocations() {
+  for (size_t i = 0; i < entity_->ChildrenCount(); ++i) {
+    Layout* const child = entity_->ChildAt(i)->GetLayout();
+
+    if (child == NULL)
+      continue;
+
+    const Native* const native = child->entity_->GetNative();
+
+    if (native != NULL)
+      child->SetNativeLocation(child->GetLocation());
+    if ((native == NULL) || !native->IsSuperview())
+      child->CommitDescendantLocations();
+  }
+}
+
+void Layout::CacheDescendantLocations() {
+  if (descendant_locations_known_)
+    return;
+  for (size_t i = 0; i < entity_->ChildrenCount(); ++i) {
+    Layout* const child = entity_->ChildAt(i)->GetLayout();
+
+    if (child == NULL)
+      continue;
+
+    const Native* const native = child->entity_->GetNative();
+
+    child->GetLocation();
+    if ((native == NULL) || !native->IsSuperview())
+      child->CacheDescendantLocations();
+  }
+  descendant_locations_known_ = true;
+}
+
+GeometryBatch* Layout::GetGeometryBatch() const {
+  const Layout* const root_layout = entity_->GetRoot()->GetLayout();
+
+  return (root_layout == NULL) ? NULL : root_layout->geometry_batch_;
+}
+
 void Layout::SetInLayout(bool in_layout) {
   in_layout_ = in_layout;
   SetVisible(in_layout);
+  InvalidateLayout();
 }
 
 const PlatformMetrics& Layout::GetPlatformMetrics() const {
+  if (metrics_ != NULL)
+    return *metrics_;
   for (const Entity *e = entity_; e != NULL; e = e->GetParent()) {
     const Native *native = e->GetNative();
 
-    if (native != NULL)
-      return native->GetPlatformMetrics();
+    if (native != NULL) {
+      metrics_ = &native->GetPlatformMetrics();
+      return *metrics_;
+    }
   }
 
-  static PlatformMetrics no_metrics = {};
+  static const PlatformMetrics no_metrics = {};
 
   DASSERT(false);  // Platform metrics must be somewhere in the hierarchy.
   return no_metrics;
 }
 
-bool LayoutContainer::SetProperty(const char *name, const Value &value) {
-  if (strcmp(name, kPropDirection) == 0) {
-    if (value.IsValueType<String>()) {
-      const String direction_string = value.Coerce<String>();
+const PropertyTable<LayoutContainer>& LayoutContainer::Properties() {
+  static const PropertyTable<LayoutContainer> table =
+      PropertyTable<LayoutContainer>()
+          .Add(kPropDirection,
+               &LayoutContainer::SetDirectionProperty,
+               &LayoutContainer::GetDirectionProperty)
+          .Add(kPropVisible,
+               &LayoutContainer::SetVisibleProperty,
+               &LayoutContainer::GetVisibleProperty)
+          .Add(kPropMargins, NULL, &LayoutContainer::GetMarginsProperty);
+
+  return table;
+}
 
-      if (direction_string == kDirectionNameRow)
-        direction_ = kLayoutRow;
-      else if (direction_string == kDirectionNameColumn)
-        direction_ = kLayoutColumn;
-      return true;
-    } else {
-      direction_ = (LayoutDirection)value.Coerce<int32_t>();
-      return true;
-    }
-  }
-  if (strcmp(name, kPropVisible) == 0) {
-    const bool new_visible = value.Coerce<bool>();
+bool LayoutContainer::SetProperty(PropertyName name, const Value &value) {
+  const PropertyTable<LayoutContainer>::Setter setter =
+      Properties().GetSetter(name);
 
-    if (visible_ == new_visible)
-      return true;
-    // To correctly handle latent visibility, the parent's visibility is set
-    // either before or after the children, depending on the new setting.
-    if (new_visible)
-      visible_ = new_visible;
-    for (size_t i = 0; i < entity_->ChildrenCount(); ++i) {
-      Entity *child = entity_->ChildAt(i);
-
-      if (new_visible) {
-        if (child->GetLayout() != NULL)
-          child->SetProperty(
-              kPropVisible, child->GetLayout()->GetLatentVisibility());
-      } else {
-        child->SetProperty(kPropVisible, false);
-      }
-    }
-    if (!new_visible)
-      visible_ = new_visible;
+  if (setter != NULL)
+    return (this->*setter)(value);
+  return Layout::SetProperty(name, value);
+}
+
+Value LayoutContainer::GetProperty(PropertyName name) const {
+  const PropertyTable<LayoutContainer>::Getter getter =
+      Properties().GetGetter(name);
+
+  if (getter != NULL)
+    return (this->*getter)();
+  return Layout::GetProperty(name);
+}
+
+bool LayoutContainer::SetDirectionProperty(const Value &value) {
+  if (value.IsValueType<String>()) {
+    const String direction_string = value.Coerce<String>();
+
+    if (direction_string == kDirectionNameRow)
+      direction_ = kLayoutRow;
+    else if (direction_string == kDirectionNameColumn)
+      direction_ = kLayoutColumn;
+    return true;
+  } else {
+    direction_ = (LayoutDirection)value.Coerce<int32_t>();
     return true;
   }
-  return Layout::SetProperty(name, value);
 }
 
-Value LayoutContainer::GetProperty(const char *name) const {
-  if (strcmp(name, kPropDirection) == 0) {
-    return direction_;
+bool LayoutContainer::SetVisibleProperty(const Value &value) {
+  const bool new_visible = value.Coerce<bool>();
+
+  if (visible_ == new_visible)
+    return true;
+  // To correctly handle latent visibility, the parent's visibility is set
+  // either before or after the children, depending on the new setting.
+  if (new_visible) {
+    visible_ = new_visible;
+    InvalidateDescendantVisibility();
   }
-  if (strcmp(name, kPropVisible) == 0) {
-    return visible_;
+  for (size_t i = 0; i < entity_->ChildrenCount(); ++i) {
+    Entity *child = entity_->ChildAt(i);
+
+    if (new_visible) {
+      if (child->GetLayout() != NULL)
+        child->SetProperty(
+            kPropVisible, child->GetLayout()->GetLatentVisibility());
+    } else {
+      child->SetProperty(kPropVisible, false);
+    }
   }
-  if (strcmp(name, kPropMargins) == 0) {
-    return GetMargins();
+  if (!new_visible) {
+    visible_ = new_visible;
+    InvalidateDescendantVisibility();
   }
-  return Layout::GetProperty(name);
+  return true;
+}
+
+Value LayoutContainer::GetDirectionProperty() const {
+  return direction_;
+}
+
+Value LayoutContainer::GetVisibleProperty() const {
+  return visible_;
+}
+
+Value LayoutContainer::GetMarginsProperty() const {
+  return GetMargins();
 }
 
 Spacing LayoutContainer::GetMargins() const {
@@ -430,48 +739,139 @@ int32_t LayoutContainer::GetBaseline() const {
 }
 
 void LayoutContainer::InvalidateLayout() {
-  cached_min_size_ = Size();
+  min_size_valid_ = false;
+  needs_layout_ = true;
+  resize_items_valid_ = false;
   Layout::InvalidateLayout();
 }
 
 void LayoutContainer::SetSize(const Size &s) {
-  if (s == GetSize())
+  // If nothing inside has changed, the children are already in place.
+  if (!needs_layout_ && (s == GetSize()))
     return;
 
+  GeometryBatch batch(this);
   Size new_size;
   uint32_t extra;
 
+  // Cleared first so that invalidations during layout are kept for the
+  // next pass.
+  needs_layout_ = false;
+  // When only the size has changed, as when the user resizes the window,
+  // the minimum sizes are the same and only the fill space changes.
+  // Invalidating the layout also invalidates the resize items.
+  if (QuickResize(s))
+    return;
   // Resizing a container is done in two phases: setting the sizes of the
   // children, and then setting their locations.
   SetObjectSizes(s, &new_size, &extra);
   ArrangeObjects(new_size, extra);
+  if (needs_layout_ || !min_size_valid_)
+    resize_items_valid_ = false;
 }
 
-void LayoutContainer::SetLocation(const Location &loc) {
-  const Location current = GetLocation();
-  const Location offset(loc.x-current.x, loc.y-current.y);
+bool LayoutContainer::QuickResize(const Size &s) {
+  if (!resize_items_valid_ || !min_size_valid_)
+    return false;
+
+  const Size new_size(
+      std::max(s.width, cached_min_size_.width),
+      std::max(s.height, cached_min_size_.height));
+  const uint32_t extra = ExtraSpace(StreamDim(new_size));
+  const uint32_t fill =
+      (resize_fill_count_ == 0) ? 0 : (extra / resize_fill_count_);
+  uint32_t remainder =
+      (resize_fill_count_ == 0) ? 0 : (extra % resize_fill_count_);
+  const Spacing &margins = resize_margins_;
+  int32_t prev_pad = StreamBefore(margins);
+  int32_t last_edge = 0;
+  bool mins_changed = false;
 
-  SetLocationImp(loc);
+  SetSizeImp(new_size);
+  if (resize_fill_count_ == 0) {
+    if (stream_align_ == kAlignCenter)
+      last_edge += extra / 2;
+    else if (stream_align_ == kAlignEnd)
+      last_edge += extra;
+  }
+  for (size_t i = 0; i < resize_items_.size(); ++i) {
+    const ResizeItem &item = resize_items_[i];
+    Layout* const child = item.layout;
+    Size size = item.min;
+
+    if (item.cross_fill)
+      CrossDim(size) = CrossDim(new_size) -
+          (CrossBefore(margins) + CrossAfter(margins));
+    if (item.stream_fill && (resize_fill_count_ != 0)) {
+      StreamDim(size) += fill;
+      if (remainder > 0) {
+        ++StreamDim(size);
+        --remainder;
+      }
+    }
+    if ((size != child->GetSize()) || child->NeedsLayout()) {
+      child->SetSize(size);
+      if (child->GetMinimumSize() != item.min) {
+        mins_changed = true;
+        if (monitor_ != NULL)
+          monitor_->LayoutRepeated(this, child);
+      }
+    }
+    // The rest of the children are still sized as in the first iteration of
+    // a full layout, but there is no point in placing them.
+    if (mins_changed)
+      continue;
 
-  // If the native object is a superview, then subviews will be moved
-  // automatically. Otherwise, children need to be notified of the change.
-  if ((entity_->GetNative() == NULL) || (!entity_->GetNative()->IsSuperview()))
-    for (size_t i = 0; i < entity_->ChildrenCount(); ++i) {
-      Layout *layout_child = entity_->ChildAt(i)->GetLayout();
+    const Spacing padding =
+        item.padding_varies ? child->GetPadding() : item.padding;
+    const Size child_size = child->GetSize();
+    Location loc;
+    int32_t before = 0;
 
-      if (layout_child != NULL)
-        layout_child->ParentLocationChanged(offset);
+    if (i == 0)
+      before = StreamBefore(margins);
+    else if ((prev_pad >= 0) && (StreamBefore(padding) >= 0))
+      before = std::max(StreamBefore(padding), prev_pad);
+    StreamLoc(loc) = before + last_edge;
+    CrossLoc(loc) = CrossBefore(margins);
+    if (item.alignment != kAlignStart) {
+      const int32_t cross_extra = CrossDim(new_size) - CrossDim(child_size) -
+          (CrossBefore(margins) + CrossAfter(margins));
+
+      CrossLoc(loc) +=
+          (item.alignment == kAlignEnd) ? cross_extra : (cross_extra / 2);
     }
+    child->SetLocation(loc);
+    last_edge = StreamLoc(loc) + StreamDim(child_size);
+    prev_pad = StreamAfter(padding);
+  }
+  if (mins_changed) {
+    resize_items_valid_ = false;
+    min_size_valid_ = false;
+    CalculateMinimumSize();
+    return false;
+  }
+  AlignBaselines();
+  if (monitor_ != NULL)
+    monitor_->LayoutFinished(this, 1, true);
+  return true;
 }
 
-void LayoutContainer::ParentLocationChanged(const Location &offset) {
-  if (offset != Location())
-    for (size_t i = 0; i < entity_->ChildrenCount(); ++i) {
-      Layout *layout_child = entity_->ChildAt(i)->GetLayout();
-
-      if (layout_child != NULL)
-        layout_child->ParentLocationChanged(offset);
-    }
+void LayoutContainer::SetLocation(const Location &loc) {
+  const Native* const native = entity_->GetNative();
+  // If the native object is a superview, then subviews will be moved
+  // automatically. Otherwise, the children's locations relative to this
+  // object stay the same, but their native objects still have to be moved.
+  const bool move_children =
+      ((native == NULL) || !native->IsSuperview()) && (loc != GetLocation());
+
+  // The children's old locations have to be known before the move, since
+  // reading them from their native objects depends on this location.
+  if (move_children)
+    CacheDescendantLocations();
+  SetLocationImp(loc);
+  if (move_children)
+    DescendantsMoved();
 }
 
 size_t LayoutContainer::FillChildCount() const {
@@ -488,21 +888,22 @@ size_t LayoutContainer::FillChildCount() const {
   return count;
 }
 
-static const size_t kMaxLayoutIterations = 3;
-
 void LayoutContainer::SetObjectSizes(
     const Size &s, Size *new_size, uint32_t *extra) {
   const Spacing margins = GetMargins();
   const unsigned int fill_count = FillChildCount();
   bool layout_valid = false;
+  size_t iterations = 0;
 
   // For some objects, such as wrapped text, changing their size in one
   // direction will affect their minimum size in the other. When that happens,
-  // the object will call InvalidateLayout, and the loop will be executed again.
-  for (size_t i = 0; !layout_valid && (i < kMaxLayoutIterations); ++i) {
+  // the children are sized again until their minimum sizes stop changing.
+  while (!layout_valid && (iterations < kMaxLayoutIterations)) {
     layout_valid = true;
-    if (cached_min_size_ == Size())
+    if (!min_size_valid_) {
       cached_min_size_ = GetMinimumSize();
+      min_size_valid_ = true;
+    }
 
     *new_size = Size(
         std::max(s.width, cached_min_size_.width),
@@ -548,29 +949,45 @@ void LayoutContainer::SetObjectSizes(
           StreamDim(size) = StreamDim(min);
         }
       }
+      // When repeating, only the children that are changing are set again.
+      if ((iterations != 0) && (size == child->GetSize()) &&
+          !child->NeedsLayout())
+        continue;
       child->SetSize(size);
       // With wrapped text, changing the width may change the desired height.
-      if (child->GetMinimumSize() != min)
+      if (child->GetMinimumSize() != min) {
         layout_valid = false;
+        if (monitor_ != NULL)
+          monitor_->LayoutRepeated(this, child);
+      }
     }
+    ++iterations;
     if (!layout_valid) {
-      cached_min_size_ = Size();
+      min_size_valid_ = false;
       CalculateMinimumSize();
     }
   }
+  if (monitor_ != NULL)
+    monitor_->LayoutFinished(this, iterations, layout_valid);
   if (fill_count != 0)
     *extra = 0;
 }
 
 void LayoutContainer::ArrangeObjects(const Size &new_size, uint32_t extra) {
+  const bool reverse_row = (direction_ == kLayoutRow) && IsRTL();
+  const bool reverse_col = (direction_ == kLayoutColumn) && IsRTL();
+
+  // The items are filled in along the way for QuickResize, which only
+  // handles the forward direction.
+  resize_items_.clear();
+  resize_fill_count_ = 0;
+  resize_items_valid_ = !reverse_row && !reverse_col;
   if (entity_->ChildrenCount() == 0)
     return;
 
   const Spacing margins = GetMargins();
   int32_t prev_pad = StreamBefore(margins);
   int32_t last_edge = 0;
-  const bool reverse_row = (direction_ == kLayoutRow) && IsRTL();
-  const bool reverse_col = (direction_ == kLayoutColumn) && IsRTL();
 
   switch (reverse_row ? ReverseAlignment(stream_align_) : stream_align_) {
     case kAlignStart:
@@ -626,7 +1043,27 @@ void LayoutContainer::ArrangeObjects(const Size &new_size, uint32_t extra) {
     last_edge = StreamLoc(child->GetLocation()) + StreamDim(child->GetSize());
     prev_pad = StreamAfter(padding);
     first = false;
+
+    if (resize_items_valid_) {
+      const Size max = child->GetMaximumSize();
+      ResizeItem item;
+
+      item.layout = child;
+      item.min = child->GetMinimumSize();
+      item.padding = padding;
+      item.padding_varies = (child->GetFlatKind() == kFlatGroup) ||
+          (child->GetFlatKind() == kFlatMultipanel);
+      item.stream_fill = (StreamSizeOption(*child) == kSizeFill) ||
+          (StreamDim(max) == kSizeFill);
+      item.cross_fill = (CrossSizeOption(*child) == kSizeFill) ||
+          (CrossDim(max) == kSizeFill);
+      item.alignment = child_align;
+      resize_items_.push_back(item);
+      if (StreamSizeOption(*child) == kSizeFill)
+        ++resize_fill_count_;
+    }
   }
+  resize_margins_ = margins;
   AlignBaselines();
 }
 
@@ -691,7 +1128,7 @@ void LayoutContainer::AlignBaselines() {
 }
 
 Size LayoutContainer::CalculateMinimumSize() const {
-  if (cached_min_size_ != Size())
+  if (min_size_valid_)
     return cached_min_size_;
 
   Size min_size;
@@ -760,35 +1197,54 @@ Size LayoutContainer::CalculateMinimumSize() const {
   max_size_.width =  std::min(max_size_.width,  min_size.width);
   max_size_.height = std::min(max_size_.height, min_size.height);
   cached_min_size_ = min_size;
+  min_size_valid_ = true;
   return min_size;
 }
 
 void LayoutContainer::SetSizeImp(const Size &size) {
   if (entity_ != NULL)
-    entity_->SetNativeProperty(kPropSize, size);
+    SetNativeSize(size);
 }
 
 void LayoutContainer::SetLocationImp(const Location &loc) {
   if (entity_ != NULL)
-    entity_->SetNativeProperty(kPropLocation, loc);
+    SetNativeLocation(loc);
 }
 
 void LayoutContainer::ResizeToMinimum() {
-  cached_min_size_ = Size();
+  GeometryBatch batch(this);
+
+  min_size_valid_ = false;
 
-  for (size_t i = 0; i < kMaxLayoutIterations; ++i) {
+  size_t iterations = 0;
+  bool converged = false;
+
+  for (; iterations < kMaxLayoutIterations; ++iterations) {
     const Size min = GetMinimumSize();
 
-    if (min == GetSize())
+    converged = (min == GetSize()) && !needs_layout_;
+    if (converged)
       break;
     SetSize(min);
     if (min != GetSize())
-      cached_min_size_ = Size();
+      min_size_valid_ = false;
   }
+  if (monitor_ != NULL)
+    monitor_->PassFinished(this, iterations, converged);
+}
+
+void LayoutContainer::UpdateLayout() {
+  GeometryBatch batch(this);
+  size_t iterations = 0;
+
+  for (; needs_layout_ && (iterations < kMaxLayoutIterations); ++iterations)
+    SetSize(GetSize());
+  if (monitor_ != NULL)
+    monitor_->PassFinished(this, iterations, !needs_layout_);
 }
 
 Size BorderedContainer::CalculateMinimumSize() const {
-  if (cached_min_size_ != Size())
+  if (min_size_valid_)
     return cached_min_size_;
 
   cached_min_size_ = LayoutContainer::CalculateMinimumSize();
@@ -869,34 +1325,59 @@ void Group::CalculatePadding() {
   }
 }
 
+const PropertyTable<Group>& Group::Properties() {
+  static const PropertyTable<Group> table = PropertyTable<Group>()
+      .Add(kPropLocation,
+           &Group::SetLocationProperty, &Group::GetLocationProperty)
+      .Add(kPropSize, NULL, &Group::GetSizeProperty)
+      .Add(kPropValue, &Group::SetValueProperty, &Group::GetValueProperty);
+
+  return table;
+}
+
 bool Group::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropLocation) == 0) {
-    SetLocation(value.Coerce<Location>());
-    return true;
-  }
-  if (strcmp(name, kPropValue) == 0) {
-    if (entity_->ChildrenCount() > 0)
-      return entity_->ChildAt(0)->SetProperty(kPropValue, value);
-    else
-      return true;
-  }
+  const PropertyTable<Group>::Setter setter = Properties().GetSetter(name);
+
+  if (setter != NULL)
+    return (this->*setter)(value);
   return LayoutContainer::SetProperty(name, value);
 }
 
 Value Group::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropLocation) == 0)
-    return GetLocation();
-  if (strcmp(name, kPropSize) == 0)
-    return GetSize();
-  if (strcmp(name, kPropValue) == 0) {
-    if (entity_->ChildrenCount() > 0)
-      return entity_->ChildAt(0)->GetProperty(kPropValue);
-    else
-      return Value();
-  }
+  const PropertyTable<Group>::Getter getter = Properties().GetGetter(name);
+
+  if (getter != NULL)
+    return (this->*getter)();
   return LayoutContainer::GetProperty(name);
 }
 
+bool Group::SetLocationProperty(const Value &value) {
+  SetLocation(value.Coerce<Location>());
+  return true;
+}
+
+bool Group::SetValueProperty(const Value &value) {
+  if (entity_->ChildrenCount() > 0)
+    return entity_->ChildAt(0)->SetProperty(kPropValue, value);
+  else
+    return true;
+}
+
+Value Group::GetLocationProperty() const {
+  return GetLocation();
+}
+
+Value Group::GetSizeProperty() const {
+  return GetSize();
+}
+
+Value Group::GetValueProperty() const {
+  if (entity_->ChildrenCount() > 0)
+    return entity_->ChildAt(0)->GetProperty(kPropValue);
+  else
+    return Value();
+}
+
 void Group::ChildValueChanged(Entity *child) {
   DASSERT(entity_->ChildrenCount() > 0);
   if ((child == entity_->ChildAt(0)) && (entity_->GetParent() != NULL))
@@ -944,37 +1425,63 @@ void Multipanel::CalculatePadding() {
   }
 }
 
+const PropertyTable<Multipanel>& Multipanel::Properties() {
+  static const PropertyTable<Multipanel> table = PropertyTable<Multipanel>()
+      .Add(kPropValue,
+           &Multipanel::SetValueProperty, &Multipanel::GetValueProperty)
+      .Add(kPropVisible, &Multipanel::SetVisibleProperty);
+
+  return table;
+}
+
 bool Multipanel::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropValue) == 0) {
-    ShowPanel(value.Coerce<size_t>());
-    return true;
-  }
-  if (strcmp(name, kPropVisible) == 0) {
-    const bool visible = value.Coerce<bool>();
+  const PropertyTable<Multipanel>::Setter setter =
+      Properties().GetSetter(name);
 
-    if (visible)
-      ShowPanel(value_);
-    else
-      Group::SetProperty(name, value);
-    return true;
-  }
+  if (setter != NULL)
+    return (this->*setter)(value);
   return Group::SetProperty(name, value);
 }
 
 Value Multipanel::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropValue) == 0)
-    return value_;
+  const PropertyTable<Multipanel>::Getter getter =
+      Properties().GetGetter(name);
+
+  if (getter != NULL)
+    return (this->*getter)();
   return Group::GetProperty(name);
 }
 
+bool Multipanel::SetValueProperty(const Value &value) {
+  ShowPanel(value.Coerce<size_t>());
+  return true;
+}
+
+bool Multipanel::SetVisibleProperty(const Value &value) {
+  const bool visible = value.Coerce<bool>();
+
+  if (visible)
+    ShowPanel(value_);
+  else
+    Group::SetProperty(kPropVisible, value);
+  return true;
+}
+
+Value Multipanel::GetValueProperty() const {
+  return value_;
+}
+
 void Multipanel::SetObjectSizes(
     const Size &s, Size *new_size, uint32_t *extra) {
   bool layout_valid = false;
+  size_t iterations = 0;
 
-  for (size_t i = 0; !layout_valid && (i < kMaxLayoutIterations); ++i) {
+  while (!layout_valid && (iterations < kMaxLayoutIterations)) {
     layout_valid = true;
-    if (cached_min_size_ == Size())
+    if (!min_size_valid_) {
       cached_min_size_ = GetMinimumSize();
+      min_size_valid_ = true;
+    }
     *new_size = Size(
         std::max(s.width, cached_min_size_.width),
         std::max(s.height, cached_min_size_.height));
@@ -994,23 +1501,38 @@ void Multipanel::SetObjectSizes(
       if (child->GetVSizeOption() == kSizeFill)
         child_size.height = s.height;
 
+      if ((iterations != 0) && (child_size == child->GetSize()) &&
+          !child->NeedsLayout())
+        continue;
       child->SetSize(child_size);
-      if (child->GetMinimumSize() != min)
+      if (child->GetMinimumSize() != min) {
         layout_valid = false;
+        if (monitor_ != NULL)
+          monitor_->LayoutRepeated(this, child);
+      }
     }
+    ++iterations;
     if (!layout_valid) {
-      cached_min_size_ = Size();
+      min_size_valid_ = false;
       CalculateMinimumSize();
     }
   }
+  if (monitor_ != NULL)
+    monitor_->LayoutFinished(this, iterations, layout_valid);
 }
 
 void Multipanel::ArrangeObjects(const Size &new_size, uint32_t extra) {
   // Extra parens so this isn't parsed as a function
   const Value location_value((Location()));
 
-  for (size_t i = 0; i < entity_->ChildrenCount(); ++i)
-    entity_->ChildAt(i)->SetProperty(kPropLocation, location_value);
+  for (size_t i = 0; i < entity_->ChildrenCount(); ++i) {
+    Layout* const child = entity_->ChildAt(i)->GetLayout();
+
+    if (child != NULL)
+      child->SetLocation(Location());
+    else
+      entity_->ChildAt(i)->SetProperty(kPropLocation, location_value);
+  }
 }
 
 Size Multipanel::CalculateMinimumSize() const {
@@ -1044,6 +1566,183 @@ void Multipanel::ShowPanel(size_t index) {
   }
 }
 
+void SizeGroups::Add(Layout *layout) {
+  if (!layout->GetWidthName().IsEmpty())
+    AddMember(&widths_, layout->GetWidthName(), layout);
+  if (!layout->GetHeightName().IsEmpty())
+    AddMember(&heights_, layout->GetHeightName(), layout);
+}
+
+void SizeGroups::Remove(Layout *layout) {
+  if (!layout->GetWidthName().IsEmpty())
+    RemoveMember(&widths_, layout->GetWidthName(), layout);
+  if (!layout->GetHeightName().IsEmpty())
+    RemoveMember(&heights_, layout->GetHeightName(), layout);
+}
+
+void SizeGroups::AddTree(Entity *entity) {
+  if (entity->GetLayout() != NULL)
+    Add(entity->GetLayout());
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    AddTree(entity->ChildAt(i));
+}
+
+void SizeGroups::RemoveTree(Entity *entity) {
+  if (entity->GetLayout() != NULL)
+    Remove(entity->GetLayout());
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    RemoveTree(entity->ChildAt(i));
+}
+
+void SizeGroups::MemberChanged(Layout *layout) {
+  if (!layout->GetWidthName().IsEmpty())
+    InvalidateGroup(&widths_, layout->GetWidthName());
+  if (!layout->GetHeightName().IsEmpty())
+    InvalidateGroup(&heights_, layout->GetHeightName());
+}
+
+void SizeGroups::AddMember(
+    GroupMap *groups, const String &name, Layout *layout) {
+  Group *group = groups->Find(name);
+
+  if (group == NULL) {
+    groups->Insert(name, Group());
+    group = groups->Find(name);
+  } else if (group->indices.Exists(layout)) {
+    return;
+  } else {
+    InvalidateGroup(groups, name);
+  }
+  group->indices.Insert(layout, group->members.size());
+  group->members.push_back(layout);
+}
+
+void SizeGroups::RemoveMember(
+    GroupMap *groups, const String &name, Layout *layout) {
+  Group* const group = groups->Find(name);
+
+  if (group == NULL)
+    return;
+
+  const size_t* const index = group->indices.Find(layout);
+
+  if (index == NULL)
+    return;
+
+  // The last member takes the removed one's place.
+  Layout* const last = group->members.back();
+
+  group->members[*index] = last;
+  group->indices.Insert(last, *index);
+  group->members.pop_back();
+  group->indices.Remove(layout);
+  if (group->members.empty())
+    groups->Remove(name);
+  else
+    InvalidateGroup(groups, name);
+}
+
+void SizeGroups::InvalidateGroup(GroupMap *groups, const String &name) {
+  Group* const group = groups->Find(name);
+
+  // If the group is already invalid, the members' containers have already
+  // been invalidated and have not been laid out since.
+  if ((group == NULL) || !group->valid)
+    return;
+  group->valid = false;
+  for (size_t i = 0; i < group->members.size(); ++i) {
+    Layout* const parent = group->members[i]->GetLayoutParent();
+
+    if (parent != NULL)
+      parent->InvalidateLayout();
+  }
+}
+
+uint32_t SizeGroups::GetSize(
+    GroupMap *groups, Layout::Dimension dimension, const String &name) {
+  Group* const group = groups->Find(name);
+
+  if (group == NULL)
+    return 0;
+  if (!group->valid) {
+    // Marked valid first so that a member nested inside another member sees
+    // the partial result instead of recursing.
+    group->size = 0;
+    group->valid = true;
+    for (size_t i = 0; i < group->members.size(); ++i) {
+      const Size member_size = group->members[i]->CalculateMinimumSize();
+
+      group->size = std::max<uint32_t>(
+          group->size, (dimension == Layout::kDimensionWidth) ?
+              member_size.width : member_size.height);
+    }
+  }
+  return group->size;
+}
+
+GeometryBatch::GeometryBatch(Layout *layout) : root_(NULL) {
+  Layout* const root_layout = layout->entity_->GetRoot()->GetLayout();
+
+  if ((root_layout != NULL) && (root_layout->geometry_batch_ == NULL)) {
+    root_ = root_layout;
+    root_->geometry_batch_ = this;
+  }
+}
+
+GeometryBatch::~GeometryBatch() {
+  if (root_ == NULL)
+    return;
+
+  // Natives may look at the pending geometry of other objects while the
+  // changes are applied, such as to find their superview's location, so the
+  // pending values are only cleared afterward.
+  Array<GeometryChange> changes;
+
+  // Moving the descendants of moved containers adds them to the batch, so
+  // that is done first.
+  for (size_t i = 0; i < moved_.size(); ++i) {
+    moved_[i]->descendants_moved_ = false;
+    moved_[i]->CommitDescendantLocations();
+  }
+  root_->geometry_batch_ = NULL;
+  for (size_t i = 0; i < layouts_.size(); ++i) {
+    const Layout* const layout = layouts_[i];
+    Native* const native = layout->entity_->GetNative();
+    GeometryChange change = {
+        native, false, false, layout->pending_size_, layout->location_ };
+
+    if (native == NULL)
+      continue;
+    if (layout->size_pending_) {
+      const Value old_size = native->GetProperty(kPropSize);
+
+      change.set_size = !old_size.IsValid() ||
+          (layout->pending_size_ != old_size.Coerce<Size>());
+    }
+    if (layout->location_pending_) {
+      const Value old_location = native->GetProperty(kPropLocation);
+
+      change.set_location = !old_location.IsValid() ||
+          (layout->location_ != old_location.Coerce<Location>());
+    }
+    if (change.set_size || change.set_location)
+      changes.push_back(change);
+  }
+  if (!changes.empty()) {
+    Native* const root_native = root_->entity_->GetNative();
+
+    if (root_native != NULL)
+      root_native->CommitGeometry(changes);
+    else
+      Native::ApplyGeometry(changes);
+  }
+  for (size_t i = 0; i < layouts_.size(); ++i) {
+    layouts_[i]->size_pending_ = false;
+    layouts_[i]->location_pending_ = false;
+    layouts_[i]->in_geometry_batch_ = false;
+  }
+}
+
 Size Spacer::CalculateMinimumSize() const {
   const PlatformMetrics &metrics = GetPlatformMetrics();
   Size result;
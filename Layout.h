@@ -21,6 +21,9 @@
 
 namespace Diadem {
 
+class FlatLayout;
+class GeometryBatch;
+class Layout;
 class LayoutContainer;
 
 enum SizeOption {
@@ -51,15 +54,65 @@ extern const StringConstant kAlignNameStart, kAlignNameCenter, kAlignNameEnd;
 
 extern const StringConstant kDirectionNameRow, kDirectionNameColumn;
 
+// Containers size their children again as long as that changes the
+// children's minimum sizes, such as with wrapped text. This limit is only
+// reached if the sizes keep changing, which is reported to the LayoutMonitor.
+const size_t kMaxLayoutIterations = 10;
+
+// Counts of how leaf minimum sizes were found, for tests and profiling. They
+// are updated atomically, since leaves may be measured on several threads.
+struct MeasurementCounts {
+  MeasurementCounts() : measured(0), cached(0) {}
+
+  size_t measured;  // Requested from the entity, usually the native object
+  size_t cached;    // Answered from the layout object's cache
+};
+
+// Receives reports on how layout passes converge, for finding layouts that
+// take more iterations than expected or never settle. Install one with
+// Layout::SetMonitor(). There is one monitor for all hierarchies, and it is
+// called on whichever thread is doing the layout, such as a BatchLoader's
+// threads, so it must be thread-safe if layouts run on more than one.
+class LayoutMonitor {
+ public:
+  virtual ~LayoutMonitor() {}
+
+  // The container is sizing its children again because sizing the given
+  // child changed its minimum size.
+  virtual void LayoutRepeated(const Layout *container, const Layout *child) {}
+  // The container has sized its children, taking the given number of
+  // iterations. If converged is false, it stopped at kMaxLayoutIterations
+  // while minimum sizes were still changing.
+  virtual void LayoutFinished(
+      const Layout *container, size_t iterations, bool converged) {}
+  // A ResizeToMinimum() or UpdateLayout() pass on the root has finished,
+  // having set its size the given number of times.
+  virtual void PassFinished(
+      const Layout *root, size_t iterations, bool converged) {}
+};
+
 // A layout object manages an Entity's place in the dialog layout.
 class Layout : public EntityDelegate {
  public:
   enum LayoutDirection { kLayoutRow, kLayoutColumn };
+  // How FlatLayout handles the object. Leaves are measured and sized through
+  // their own methods, while containers are laid out by FlatLayout's copy of
+  // their class's algorithm. Subclasses that change the algorithm have to
+  // return kFlatUnsupported.
+  enum FlatKind {
+    kFlatLeaf, kFlatContainer, kFlatBordered, kFlatGroup, kFlatMultipanel,
+    kFlatUnsupported
+  };
 
   Layout()
       : in_layout_(true), latent_visibility_(true),
         h_size_(kSizeDefault), v_size_(kSizeDefault),
-        align_(kAlignStart) {}
+        align_(kAlignStart), measurement_valid_(false), metrics_(NULL),
+        ancestors_visible_(true), ancestors_visible_valid_(false),
+        location_known_(false), descendant_locations_known_(false),
+        size_pending_(false), location_pending_(false),
+        in_geometry_batch_(false), descendants_moved_(false),
+        geometry_batch_(NULL) {}
   virtual ~Layout() {}
 
   void InitializeProperties(const PropertyMap &properties);
@@ -76,30 +129,38 @@ class Layout : public EntityDelegate {
   virtual bool SetProperty(PropertyName name, const Value &value);
   virtual Value GetProperty(PropertyName name) const;
 
-  // True if all the entity's ancestors are visible.
+  // True if all the entity's ancestors are visible. The result is cached, and
+  // containers clear their descendants' caches when their visibility changes.
   bool AreAncestorsVisible() const;
   bool GetLatentVisibility() const { return latent_visibility_; }
 
   virtual void Finalize() { ResizeToMinimum(); }
 
-  // Layout is done repeatedly until nobody calls InvalidateLayout.
+  // Marks the object and its ancestors as needing to be measured and laid
+  // out again. Nothing is recalculated until the next layout pass, such as
+  // Window::UpdateLayout(), so several changes can share one pass. Containers
+  // that were not invalidated keep their cached measurements, and are skipped
+  // by the layout pass if their size doesn't change.
   virtual void InvalidateLayout();
+  // True if the object has been invalidated since it was last laid out.
+  virtual bool NeedsLayout() const { return false; }
+  // Lays out the invalidated parts of the hierarchy, keeping the current size
+  // if it is still big enough.
+  virtual void UpdateLayout() {}
 
   // Returns the layout direction of the object, or the parent container.
   virtual LayoutDirection GetDirection() const;
 
-  virtual void SetSize(const Size &size)
-    { entity_->SetNativeProperty(kPropSize, size); }
-  virtual Size GetSize() const
-    { return entity_->GetNativeProperty(kPropSize).Coerce<Size>(); }
+  virtual void SetSize(const Size &size) { SetNativeSize(size); }
+  virtual Size GetSize() const { return GetNativeSize(); }
 
-  virtual void SetLocation(const Location &loc)
-    { entity_->SetNativeProperty(kPropLocation, loc); }
-  virtual Location GetLocation() const
-    { return entity_->GetNativeProperty(kPropLocation).Coerce<Location>(); }
+  virtual void SetLocation(const Location &loc) { SetNativeLocation(loc); }
+  virtual Location GetLocation() const { return GetNativeLocation(); }
 
   // Get the location relative to the native view. This may be different from
-  // GetLocation() if the object is inside a Group.
+  // GetLocation() if the object is inside a Group. Locations are stored
+  // relative to the parent container, so this adds up the locations of
+  // ancestors up to the nearest superview.
   virtual Location GetViewLocation() const;
 
   // Padding is the minimum distance around an object.
@@ -110,6 +171,7 @@ class Layout : public EntityDelegate {
     { return entity_->GetProperty(kPropBaseline).Coerce<int32_t>(); }
 
   AlignOption GetAlignment() const { return align_; }
+  virtual FlatKind GetFlatKind() const { return kFlatLeaf; }
 
   virtual Size GetMinimumSize() const
     { return EnforceExplicitSize(CalculateMinimumSize()); }
@@ -132,21 +194,46 @@ class Layout : public EntityDelegate {
 
   const String& GetWidthName() const  { return width_name_; }
   const String& GetHeightName() const { return height_name_; }
-  void SetWidthName(const String &name)  { width_name_ = name; }
-  void SetHeightName(const String &name) { height_name_ = name; }
-
-  // Notification that the parent's location has changed, so this child should
-  // adjust itself accordingly.
-  virtual void ParentLocationChanged(const Location &offset);
+  void SetWidthName(const String &name);
+  void SetHeightName(const String &name);
 
   SizeOption GetHSizeOption() const { return h_size_; }
   SizeOption GetVSizeOption() const { return v_size_; }
   void SetHSizeOption(SizeOption h_size) { h_size_ = h_size; }
   void SetVSizeOption(SizeOption v_size) { v_size_ = v_size; }
   const ExplicitSize& GetExplicitSize() { return explicit_size_; }
+  // Sets an explicit width or height that has already been parsed, as for
+  // compiled resources.
+  void SetExplicitWidth(float width, Unit units) {
+    explicit_size_.width_ = width;
+    explicit_size_.width_units_ = units;
+    h_size_ = kSizeExplicit;
+  }
+  void SetExplicitHeight(float height, Unit units) {
+    explicit_size_.height_ = height;
+    explicit_size_.height_units_ = units;
+    v_size_ = kSizeExplicit;
+  }
 
   const PlatformMetrics& GetPlatformMetrics() const;
 
+  // Notification that the entity has been moved in the hierarchy, or that the
+  // native objects above it have changed, so cached state that depends on
+  // the ancestors needs to be found again.
+  void AncestorsChanged();
+
+  // Totals for all layout objects since the last reset.
+  static const MeasurementCounts& GetMeasurementCounts()
+    { return measurement_counts_; }
+  static void ResetMeasurementCounts()
+    { measurement_counts_ = MeasurementCounts(); }
+
+  // Sets the monitor for all layout objects. Pass NULL to remove it. This is
+  // not synchronized, so it should only be called while no layout is in
+  // progress on any thread.
+  static void SetMonitor(LayoutMonitor *monitor) { monitor_ = monitor; }
+  static LayoutMonitor* GetMonitor() { return monitor_; }
+
  protected:
   bool in_layout_;
   bool latent_visibility_;
@@ -155,9 +242,76 @@ class Layout : public EntityDelegate {
   String width_name_, height_name_;
   AlignOption align_;
 
+  // Cached result of the entity's kPropMinimumSize. Minimum sizes depend at
+  // most on the current width, as with wrapped text, so the cache is keyed
+  // by that. It is cleared by InvalidateLayout and by setting properties
+  // that affect measurement, such as the text.
+  mutable Size measured_size_;
+  mutable int32_t measured_width_;
+  mutable bool measurement_valid_;
+
+  static MeasurementCounts measurement_counts_;
+  static LayoutMonitor *monitor_;
+
+  // Found from the nearest native object by GetPlatformMetrics.
+  mutable const PlatformMetrics *metrics_;
+  // Cached result of AreAncestorsVisible. If an object's cache is invalid,
+  // so are its descendants', which lets InvalidateDescendantVisibility stop
+  // early.
+  mutable bool ancestors_visible_;
+  mutable bool ancestors_visible_valid_;
+
+  // Clears the cached ancestor visibility of the entity's descendants.
+  void InvalidateDescendantVisibility();
+  static void InvalidateAncestorVisibility(Entity *entity);
+
+  // The location relative to the parent container. Until it is set, it is
+  // read from the native object the first time it is needed.
+  mutable Location location_;
+  mutable bool location_known_;
+  // True when the locations of all descendants up to the nearest superview
+  // are known, so the container can be moved without asking their native
+  // objects where they are.
+  bool descendant_locations_known_;
+
+  // Geometry held during a layout pass, to be committed to the native object
+  // by the GeometryBatch when the pass is over.
+  Size pending_size_;
+  mutable bool size_pending_;
+  bool location_pending_;
+  bool in_geometry_batch_;
+  // True for a container without a superview that has been moved during the
+  // batch, so its descendants' native objects need to be moved too.
+  bool descendants_moved_;
+  // The batch in progress, only set on the root layout object.
+  GeometryBatch *geometry_batch_;
+
+  // The native object's geometry. While a GeometryBatch is in progress,
+  // changes are held in the layout object, and the getters return them.
+  void SetNativeSize(const Size &size);
+  Size GetNativeSize() const;
+  void SetNativeLocation(const Location &loc);
+  Location GetNativeLocation() const;
+  // Notes that the container has moved, so the native objects of its
+  // descendants have to be moved in their superview even though their
+  // relative locations are the same. With a batch in progress, this is left
+  // until the batch is committed.
+  void DescendantsMoved();
+  // Sets the native locations of the descendants again, down to the nearest
+  // superviews.
+  void CommitDescendantLocations();
+  // Makes sure the locations of all descendants are stored in their layout
+  // objects.
+  void CacheDescendantLocations();
+  // Returns the batch in progress for the hierarchy, if any.
+  GeometryBatch* GetGeometryBatch() const;
+
   // For each dimension, returns the greater of the given size and any
   // explicit size specified in the object.
   Size EnforceExplicitSize(const Size &size) const;
+  // Returns the explicit size in pixels. Only the dimensions whose size
+  // option is kSizeExplicit are meaningful.
+  Size CalculateExplicitSize() const;
   // Returns the smallest size allowed by the object.
   virtual Size CalculateMinimumSize() const;
 
@@ -176,8 +330,31 @@ class Layout : public EntityDelegate {
   // Find the height to be used for the object's height name.
   uint32_t FindHeightForName() const;
   // Called on the root layout object. Recursively finds the largest dimension
-  // (width or height) of an object with the given width/height name.
+  // (width or height) of an object with the given width/height name. This is
+  // only used when the root has no SizeGroups registry.
   uint32_t FindDimensionForName(Dimension dimension, const String &name) const;
+
+ private:
+  friend class FlatLayout;
+  friend class GeometryBatch;
+  friend class SizeGroups;
+
+  static const PropertyTable<Layout>& Properties();
+
+  bool SetInLayoutProperty(const Value &value);
+  bool SetVisibleProperty(const Value &value);
+  bool SetWidthOptionProperty(const Value &value);
+  bool SetHeightOptionProperty(const Value &value);
+  bool SetAlignProperty(const Value &value);
+  bool SetWidthNameProperty(const Value &value);
+  bool SetHeightNameProperty(const Value &value);
+  bool SetMeasuredProperty(const Value &value);
+  bool SetLocationProperty(const Value &value);
+  Value GetInLayoutProperty() const;
+  Value GetVisibleProperty() const;
+  Value GetFullyVisibleProperty() const;
+  Value GetWidthOptionProperty() const;
+  Value GetLocationProperty() const;
 };
 
 // Size, location and padding are stored in the object. Other Layout
@@ -197,7 +374,6 @@ class SelfMeasured : public Layout {
 
  protected:
   Size size_;
-  Location location_;
   Spacing padding_;
 };
 
@@ -207,13 +383,16 @@ class LayoutContainer : public Layout {
  public:
   LayoutContainer()
       : direction_(kLayoutRow), visible_(true),
-        stream_align_(kAlignStart), cross_align_(kAlignStart) {}
+        stream_align_(kAlignStart), cross_align_(kAlignStart),
+        min_size_valid_(false), needs_layout_(true),
+        resize_fill_count_(0), resize_items_valid_(false) {}
   virtual ~LayoutContainer() {}
 
   virtual bool SetProperty(PropertyName name, const Value &value);
   virtual Value GetProperty(PropertyName name) const;
 
   virtual LayoutDirection GetDirection() const { return direction_; }
+  virtual FlatKind GetFlatKind() const { return kFlatContainer; }
 
   // Sets the object's size and recalculates the layout of its children.
   virtual void SetSize(const Size &size);
@@ -229,6 +408,8 @@ class LayoutContainer : public Layout {
   // Signals the layout code to continue with another iteration because
   // something affecting layout has changed.
   virtual void InvalidateLayout();
+  virtual bool NeedsLayout() const { return needs_layout_; }
+  virtual void UpdateLayout();
 
  protected:
   LayoutDirection direction_;
@@ -236,17 +417,40 @@ class LayoutContainer : public Layout {
   AlignOption stream_align_, cross_align_;
   mutable Size cached_min_size_;
   mutable Size max_size_;
+  // False when cached_min_size_ and max_size_ need to be recalculated.
+  mutable bool min_size_valid_;
+  // True when the children need to be sized and arranged again even if the
+  // container's own size doesn't change.
+  bool needs_layout_;
+
+  // What the last full layout found out about a child, so that resizing the
+  // container can redistribute the fill space without measuring again.
+  struct ResizeItem {
+    Layout *layout;
+    Size min;
+    Spacing padding;
+    bool stream_fill, cross_fill;
+    bool padding_varies;  // Groups' padding depends on their size
+    AlignOption alignment;
+  };
+  Array<ResizeItem> resize_items_;
+  Spacing resize_margins_;
+  size_t resize_fill_count_;
+  // False when resize_items_ is out of date.
+  bool resize_items_valid_;
 
   // Layout is done in two main phases: setting sizes, and setting locations.
   virtual void SetObjectSizes(const Size &s, Size *new_size, uint32_t *extra);
   virtual void ArrangeObjects(const Size &new_size, uint32_t extra);
+  // Sizes and arranges the children in one pass using resize_items_. Returns
+  // false if a full layout is needed instead, because the items are out of
+  // date or because a child's minimum size changed, as with wrapped text.
+  bool QuickResize(const Size &s);
 
   // Pass size changes to the native implementation.
   virtual void SetSizeImp(const Size &size);
   // Pass location changes to the native implementation.
   virtual void SetLocationImp(const Location &loc);
-  // Pass location changes to the children.
-  virtual void ParentLocationChanged(const Location &offset);
 
   // Returns the extra space available to child objects that may want to expand
   // to fill it.
@@ -304,6 +508,17 @@ class LayoutContainer : public Layout {
     return (direction_ == kLayoutColumn) ?
         entity.GetHSizeOption() : entity.GetVSizeOption();
   }
+
+ private:
+  friend class FlatLayout;
+
+  static const PropertyTable<LayoutContainer>& Properties();
+
+  bool SetDirectionProperty(const Value &value);
+  bool SetVisibleProperty(const Value &value);
+  Value GetDirectionProperty() const;
+  Value GetVisibleProperty() const;
+  Value GetMarginsProperty() const;
 };
 
 // A container with inside margins. Children are laid out inside the margins,
@@ -313,6 +528,7 @@ class BorderedContainer : public LayoutContainer {
   BorderedContainer() { direction_ = kLayoutColumn; }
   virtual ~BorderedContainer() {}
 
+  virtual FlatKind GetFlatKind() const { return kFlatBordered; }
   virtual Size CalculateMinimumSize() const;
 };
 
@@ -324,7 +540,8 @@ class Group : public LayoutContainer {
  public:
   Group() {}
 
-  virtual String GetTypeName() const { return kTypeNameGroup; }
+  virtual TypeName GetTypeName() const { return kTypeNameGroup; }
+  virtual FlatKind GetFlatKind() const { return kFlatGroup; }
 
   // Padding may need to be recalculated when children are added.
   virtual void ChildAdded(Entity *child);
@@ -346,7 +563,6 @@ class Group : public LayoutContainer {
 
  protected:
   Size size_;
-  Location location_;
   Spacing min_padding_;
 
   // Recalculates min_padding_ when layout changes.
@@ -354,6 +570,17 @@ class Group : public LayoutContainer {
 
   void SetSizeImp(const Size &size)        { size_ = size; }
   void SetLocationImp(const Location &loc) { location_ = loc; }
+
+ private:
+  friend class FlatLayout;
+
+  static const PropertyTable<Group>& Properties();
+
+  bool SetLocationProperty(const Value &value);
+  bool SetValueProperty(const Value &value);
+  Value GetLocationProperty() const;
+  Value GetSizeProperty() const;
+  Value GetValueProperty() const;
 };
 
 // A container that only shows one of its children at a time.
@@ -364,7 +591,8 @@ class Multipanel : public Group {
   // Makes sure only the first child is visible.
   virtual void Finalize();
 
-  virtual String GetTypeName() const { return kTypeNameMulti; }
+  virtual TypeName GetTypeName() const { return kTypeNameMulti; }
+  virtual FlatKind GetFlatKind() const { return kFlatMultipanel; }
 
   virtual bool SetProperty(PropertyName name, const Value &value);
   virtual Value GetProperty(PropertyName name) const;
@@ -384,6 +612,13 @@ class Multipanel : public Group {
 
   // Shows the panel (child) at the given index.
   void ShowPanel(size_t index);
+
+ private:
+  static const PropertyTable<Multipanel>& Properties();
+
+  bool SetValueProperty(const Value &value);
+  bool SetVisibleProperty(const Value &value);
+  Value GetValueProperty() const;
 };
 
 // A layout entity that overrides the default space between entities.
@@ -392,15 +627,104 @@ class Spacer : public SelfMeasured {
  public:
   Spacer() { padding_ = Spacing(-1, -1, -1, -1); }
 
-  virtual String GetTypeName() const { return kTypeNameSpacer; }
+  virtual TypeName GetTypeName() const { return kTypeNameSpacer; }
 
  protected:
   virtual Size CalculateMinimumSize() const;
 };
 
+// Keeps track of the layout objects that share each width and height name,
+// and the largest minimum size in each group, so that finding the size for a
+// name doesn't require searching the hierarchy. The RootEntity owns the
+// registry, and layout objects are added as they are named and as they are
+// attached to the hierarchy. When a member's size may have changed, the
+// group's size is recalculated the next time it is needed.
+class SizeGroups {
+ public:
+  SizeGroups() {}
+
+  // Adds or removes the layout object for any width and height names it has.
+  void Add(Layout *layout);
+  void Remove(Layout *layout);
+
+  // Adds or removes the layout objects of the entity and its descendants.
+  void AddTree(Entity *entity);
+  void RemoveTree(Entity *entity);
+
+  // Returns the largest minimum width or height of the named group's
+  // members, or 0 if there is no such group.
+  uint32_t GetWidth(const String &name)
+    { return GetSize(&widths_, Layout::kDimensionWidth, name); }
+  uint32_t GetHeight(const String &name)
+    { return GetSize(&heights_, Layout::kDimensionHeight, name); }
+
+  // Notification that the member's minimum size may have changed. The other
+  // members' containers are invalidated because their size may change too.
+  void MemberChanged(Layout *layout);
+
+ protected:
+  struct Group {
+    Group() : size(0), valid(false) {}
+
+    Array<Layout*> members;
+    HashMap<Layout*, size_t> indices;  // Each member's index in members
+    uint32_t size;
+    bool valid;
+  };
+  typedef HashMap<String, Group> GroupMap;
+
+  GroupMap widths_, heights_;
+
+  static void AddMember(GroupMap *groups, const String &name, Layout *layout);
+  static void RemoveMember(
+      GroupMap *groups, const String &name, Layout *layout);
+  static void InvalidateGroup(GroupMap *groups, const String &name);
+  static uint32_t GetSize(
+      GroupMap *groups, Layout::Dimension dimension, const String &name);
+
+ private:
+  friend class FlatLayout;
+
+  // Disallow copying
+  SizeGroups(const SizeGroups&);
+  void operator=(const SizeGroups&);
+};
+
+// Collects the geometry changes made during a layout pass, so that each native
+// object is only updated once, with its final frame, when the pass is over.
+// Frames that end up the same as before are not set at all. The changes are
+// passed to the root's Native::CommitGeometry so the platform can apply them
+// together. Batches may be nested; only the outermost one commits.
+class GeometryBatch {
+ public:
+  // Starts a batch for the hierarchy that contains the layout object.
+  explicit GeometryBatch(Layout *layout);
+  ~GeometryBatch();
+
+  // Records that the layout object has geometry to commit.
+  void Add(Layout *layout) { layouts_.push_back(layout); }
+  // Records that the container has moved, so its descendants' native objects
+  // need to be moved when the batch is committed.
+  void AddMoved(Layout *layout) { moved_.push_back(layout); }
+
+ protected:
+  Layout *root_;  // NULL if an outer batch is already in progress
+  Array<Layout*> layouts_;
+  Array<Layout*> moved_;
+
+ private:
+  // Disallow copying
+  GeometryBatch(const GeometryBatch&);
+  void operator=(const GeometryBatch&);
+};
+
 // Finds the first letter (a-z) in a string.
 const char *FirstLetter(const char *s);
 
+// Parses a width or height of fit, fill or default. Returns false for other
+// values, which are explicit sizes.
+bool ParseSizeOption(const char *c, SizeOption *size);
+
 }  // namespace Diadem
 
 #endif  // DIADEM_LAYOUT_H_
@@ -0,0 +1,235 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/LibXMLCompiler.h"
+
+#include <libxml/parser.h>
+
+#include "Diadem/CompiledFormat.h"
+#include "Diadem/Layout.h"
+
+namespace Diadem {
+
+static const char kOSAttribute[] = "os";
+
+// Collects the tables for one document.
+class Compilation {
+ public:
+  explicit Compilation(const String &os_name)
+      : os_name_(os_name), name_count_(0) {
+    AddString("");
+  }
+
+  // Names go first, so that they can be interned as a block.
+  void AddNames(xmlNode *element);
+  void AddEntity(xmlNode *element);
+
+  void Write(Array<char> *output);
+
+  bool IsEmpty() const { return entities_.empty(); }
+
+ protected:
+  const String os_name_;
+  Array<CompiledString> strings_;
+  Array<char> characters_;
+  HashMap<String, uint32_t> string_indices_;
+  uint32_t name_count_;
+  Array<CompiledEntity> entities_;
+  Array<CompiledProperty> properties_;
+  Map<Array<uint32_t>, uint32_t> property_runs_;  // Where each run starts
+
+  uint32_t AddString(const char *s);
+  bool IsIncluded(xmlNode *element) const;
+};
+
+static const char* AttributeValue(xmlAttr *attr) {
+  if (attr->children == NULL)
+    return "";
+  return (const char*)attr->children->content;
+}
+
+uint32_t Compilation::AddString(const char *s) {
+  const uint32_t *existing = string_indices_.Find(s);
+
+  if (existing != NULL)
+    return *existing;
+
+  CompiledString string;
+  size_t length;
+
+  string.hash = String::ComputeHash(s, &length);
+  string.offset = characters_.size();
+  string.length = length;
+  characters_.insert(characters_.end(), s, s + length + 1);
+  string_indices_.Insert(s, strings_.size());
+  strings_.push_back(string);
+  return strings_.size() - 1;
+}
+
+bool Compilation::IsIncluded(xmlNode *element) const {
+  if (element->type != XML_ELEMENT_NODE)
+    return false;
+
+  xmlAttr* const os = xmlHasProp(element, BAD_CAST kOSAttribute);
+
+  return (os == NULL) || (os_name_ == AttributeValue(os));
+}
+
+void Compilation::AddNames(xmlNode *element) {
+  if (!IsIncluded(element))
+    return;
+  AddString((const char*)element->name);
+  for (xmlAttr *attr = element->properties; attr != NULL; attr = attr->next)
+    AddString((const char*)attr->name);
+  for (xmlNode *child = element->children; child != NULL; child = child->next)
+    AddNames(child);
+  name_count_ = strings_.size();
+}
+
+void Compilation::AddEntity(xmlNode *element) {
+  if (!IsIncluded(element))
+    return;
+
+  const size_t index = entities_.size();
+  CompiledEntity entity;
+
+  entity.type = AddString((const char*)element->name);
+  entity.first_property = properties_.size();
+  for (xmlAttr *attr = element->properties; attr != NULL; attr = attr->next) {
+    const char* const name = (const char*)attr->name;
+    const char* const value = AttributeValue(attr);
+
+    // The platform has already been checked.
+    if (strcmp(name, kOSAttribute) == 0)
+      continue;
+
+    CompiledProperty property;
+    ExplicitSize size;
+    SizeOption option = kSizeExplicit;
+
+    property.name = AddString(name);
+    property.value = AddString(value);
+    property.kind = kCompiledPropertyString;
+    property.size_option = kSizeDefault;
+    property.units = kUnitPixels;
+    property.amount = 0;
+    if (kPropWidthOption == name) {
+      property.kind = kCompiledPropertyWidth;
+      if (!ParseSizeOption(value, &option)) {
+        size.ParseWidth(value);
+        property.units = size.width_units_;
+        property.amount = size.width_;
+      }
+      property.size_option = option;
+    } else if (kPropHeightOption == name) {
+      property.kind = kCompiledPropertyHeight;
+      if (!ParseSizeOption(value, &option)) {
+        size.ParseHeight(value);
+        property.units = size.height_units_;
+        property.amount = size.height_;
+      }
+      property.size_option = option;
+    }
+    properties_.push_back(property);
+  }
+  entity.property_count = properties_.size() - entity.first_property;
+
+  // Entities with the same properties share them.
+  Array<uint32_t> run;
+
+  for (size_t i = entity.first_property; i < properties_.size(); ++i) {
+    run.push_back(properties_[i].name);
+    run.push_back(properties_[i].value);
+  }
+  if (property_runs_.Exists(run)) {
+    properties_.resize(entity.first_property);
+    entity.first_property = property_runs_[run];
+  } else {
+    property_runs_.Insert(run, entity.first_property);
+  }
+  entities_.push_back(entity);
+  for (xmlNode *child = element->children; child != NULL; child = child->next)
+    AddEntity(child);
+  entities_[index].end = entities_.size();
+}
+
+// Appends the contents of the array to the output.
+template <class T>
+static void Append(const Array<T> &array, Array<char> *output) {
+  if (array.empty())
+    return;
+
+  const char* const data = reinterpret_cast<const char*>(&array[0]);
+
+  output->insert(output->end(), data, data + array.size() * sizeof(T));
+}
+
+void Compilation::Write(Array<char> *output) {
+  CompiledHeader header;
+
+  header.os = AddString(os_name_);
+  memcpy(header.magic, kCompiledMagic, sizeof(header.magic));
+  header.version = kCompiledVersion;
+  header.string_count = strings_.size();
+  header.name_count = name_count_;
+  header.strings_offset = sizeof(header);
+  header.entity_count = entities_.size();
+  header.entities_offset =
+      header.strings_offset + strings_.size() * sizeof(CompiledString);
+  header.property_count = properties_.size();
+  header.properties_offset =
+      header.entities_offset + entities_.size() * sizeof(CompiledEntity);
+  header.characters_size = characters_.size();
+  header.characters_offset =
+      header.properties_offset + properties_.size() * sizeof(CompiledProperty);
+  header.file_size = header.characters_offset + characters_.size();
+
+  const char* const header_data = reinterpret_cast<const char*>(&header);
+
+  output->clear();
+  output->reserve(header.file_size);
+  output->insert(output->end(), header_data, header_data + sizeof(header));
+  Append(strings_, output);
+  Append(entities_, output);
+  Append(properties_, output);
+  Append(characters_, output);
+}
+
+static bool CompileDocument(
+    xmlDocPtr document, const String &os_name, Array<char> *output) {
+  if (document == NULL)
+    return false;
+
+  Compilation compilation(os_name);
+  xmlNode* const root = xmlDocGetRootElement(document);
+
+  compilation.AddNames(root);
+  compilation.AddEntity(root);
+  xmlFreeDoc(document);
+  if (compilation.IsEmpty())
+    return false;
+  compilation.Write(output);
+  return true;
+}
+
+bool LibXMLCompiler::CompileFile(const char *path, Array<char> *output) const {
+  return CompileDocument(xmlParseFile(path), os_name_, output);
+}
+
+bool LibXMLCompiler::CompileData(const char *data, Array<char> *output) const {
+  return CompileDocument(
+      xmlParseMemory(data, strlen(data)), os_name_, output);
+}
+
+}  // namespace Diadem
@@ -0,0 +1,40 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_LIBXMLCOMPILER_H_
+#define DIADEM_LIBXMLCOMPILER_H_
+
+#include "Diadem/Factory.h"
+
+namespace Diadem {
+
+// Compiles XML resources into the format read by CompiledParser. Entities
+// whose os property doesn't match the target platform are left out, as
+// FactorySession would skip them. Returns false if the XML can't be parsed.
+class LibXMLCompiler : public Base {
+ public:
+  // The platform defaults to the one the compiler is running on.
+  LibXMLCompiler() : os_name_(FactorySession::OSName()) {}
+  explicit LibXMLCompiler(const char *os_name) : os_name_(os_name) {}
+
+  bool CompileFile(const char *path, Array<char> *output) const;
+  bool CompileData(const char *data, Array<char> *output) const;
+
+ protected:
+  String os_name_;
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_LIBXMLCOMPILER_H_
@@ -0,0 +1,123 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/LibXMLStreamParser.h"
+
+#include <libxml/parser.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Diadem/Factory.h"
+#include "Diadem/Value.h"
+
+namespace Diadem {
+
+static const size_t kChunkSize = 16 * 1024;
+
+// The parser context is its own user data, so that libxml2's error functions
+// can be used; the session is kept in its _private field.
+static FactorySession* SessionForContext(void *context) {
+  return static_cast<FactorySession*>(
+      static_cast<xmlParserCtxtPtr>(context)->_private);
+}
+
+static void StartElement(
+    void *context, const xmlChar *name, const xmlChar **attributes) {
+  PropertyMap properties;
+
+  if (attributes != NULL) {
+    for (const xmlChar **attr = attributes; attr[0] != NULL; attr += 2)
+      properties.Insert(
+          (const char*)attr[0],
+          (const char*)((attr[1] != NULL) ? attr[1] : BAD_CAST ""));
+  }
+  SessionForContext(context)->BeginEntity((const char*)name, properties);
+}
+
+static void EndElement(void *context, const xmlChar *name) {
+  SessionForContext(context)->EndEntity();
+}
+
+// Only element events are handled. Errors are reported the same way as when
+// building a document.
+static xmlParserCtxtPtr CreateContext(
+    FactorySession *session, const char *path) {
+  xmlSAXHandler handler;
+
+  memset(&handler, 0, sizeof(handler));
+  handler.startElement = &StartElement;
+  handler.endElement = &EndElement;
+  handler.warning = &xmlParserWarning;
+  handler.error = &xmlParserError;
+  handler.fatalError = &xmlParserError;
+  xmlParserCtxtPtr context =
+      xmlCreatePushParserCtxt(&handler, NULL, NULL, 0, path);
+
+  if (context != NULL)
+    context->_private = session;
+  return context;
+}
+
+// Finishes parsing, and returns the root entity if there were no errors.
+static Entity* FinishParsing(
+    xmlParserCtxtPtr context, FactorySession *session, bool succeeded) {
+  if (succeeded)
+    succeeded = (xmlParseChunk(context, NULL, 0, 1) == 0);
+  xmlFreeParserCtxt(context);
+  if (!succeeded) {
+    delete session->RootEntity();
+    return NULL;
+  }
+  return session->RootEntity();
+}
+
+Entity* LibXMLStreamParser::LoadEntityFromFile(const char *path) const {
+  FILE* const file = fopen(path, "rb");
+
+  if (file == NULL)
+    return NULL;
+
+  FactorySession session(factory_);
+  xmlParserCtxtPtr context = CreateContext(&session, path);
+
+  if (context == NULL) {
+    fclose(file);
+    return NULL;
+  }
+
+  char buffer[kChunkSize];
+  bool succeeded = true;
+
+  for (size_t length = fread(buffer, 1, sizeof(buffer), file);
+       succeeded && (length != 0);
+       length = fread(buffer, 1, sizeof(buffer), file))
+    succeeded = (xmlParseChunk(context, buffer, length, 0) == 0);
+  if (ferror(file))
+    succeeded = false;
+  fclose(file);
+  return FinishParsing(context, &session, succeeded);
+}
+
+Entity* LibXMLStreamParser::LoadEntityFromData(const char *data) const {
+  FactorySession session(factory_);
+  xmlParserCtxtPtr context = CreateContext(&session, NULL);
+
+  if (context == NULL)
+    return NULL;
+  return FinishParsing(
+      context, &session,
+      xmlParseChunk(context, data, strlen(data), 0) == 0);
+}
+
+}  // namespace Diadem
@@ -0,0 +1,41 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_LIBXMLSTREAMPARSER_H_
+#define DIADEM_LIBXMLSTREAMPARSER_H_
+
+#include "Diadem/Factory.h"
+
+namespace Diadem {
+
+// Loads entities with libxml2's SAX interface, creating each entity as its
+// element is read instead of building a document tree first. Files are read
+// in chunks, so large resources don't have to be held in memory. The results
+// are the same as with LibXMLParser; if the document turns out to be invalid,
+// whatever was created is deleted and NULL is returned.
+class LibXMLStreamParser : public Parser {
+ public:
+  explicit LibXMLStreamParser(const Factory &factory) : factory_(factory) {}
+  virtual ~LibXMLStreamParser() {}
+
+  Entity* LoadEntityFromFile(const char *path) const;
+  Entity* LoadEntityFromData(const char *data) const;
+
+ protected:
+  const Factory &factory_;
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_LIBXMLSTREAMPARSER_H_
@@ -95,6 +95,15 @@ Location Native::GetViewOffset() const {
   return view_location;
 }
 
+void Native::ApplyGeometry(const Array<GeometryChange> &changes) {
+  for (size_t i = 0; i < changes.size(); ++i)
+    if (changes[i].set_size)
+      changes[i].native->SetProperty(kPropSize, changes[i].size);
+  for (size_t i = 0; i < changes.size(); ++i)
+    if (changes[i].set_location)
+      changes[i].native->SetProperty(kPropLocation, changes[i].location);
+}
+
 static const size_t kStyleCount = 3;
 
 uint32_t Native::ParseWindowStyle(const char *style) {
@@ -138,7 +147,7 @@ void RadioGroup::Finalize() {
 }
 
 bool RadioGroup::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     SetSelectedIndex(value.Coerce<size_t>());
     return true;
   }
@@ -146,12 +155,12 @@ bool RadioGroup::SetProperty(PropertyName name, const Value &value) {
 }
 
 Value RadioGroup::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     return Spacing::Union(
         layout_->GetProperty(kPropPadding).Coerce<Spacing>(),
         layout_->GetPlatformMetrics().radio_group_padding);
   }
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     for (size_t i = 0; i < ChildrenCount(); ++i) {
       const Value value = ChildAt(i)->GetProperty(kPropValue);
 
@@ -56,8 +56,17 @@ enum WindowStyleBit {
   kStyleMinimizable = 0x04,
 };
 
+class Native;
 class WindowInterface;
 
+// A native object's new frame, as committed at the end of a layout pass.
+struct GeometryChange {
+  Native *native;
+  bool set_size, set_location;
+  Size size;
+  Location location;
+};
+
 // Wrapper for a platform-specific implementation for an Entity
 class Native : public EntityDelegate {
  public:
@@ -79,6 +88,17 @@ class Native : public EntityDelegate {
   virtual const PlatformMetrics& GetPlatformMetrics() const = 0;
   virtual WindowInterface* GetWindowInterface() { return NULL; }
 
+  // Applies the final frames from a layout pass. This is called on the root
+  // entity's native object, usually the window, so that the platform can
+  // apply all the changes together, such as with redrawing suspended. The
+  // default calls ApplyGeometry.
+  virtual void CommitGeometry(const Array<GeometryChange> &changes)
+    { ApplyGeometry(changes); }
+  // Sets the size and location properties for each change. All the sizes
+  // are set first, because locations may depend on the size of the
+  // superview.
+  static void ApplyGeometry(const Array<GeometryChange> &changes);
+
   typedef Factory::NoLayout LayoutType;
 
   // Parses a window's style attribute into a combination of WindowStyleBits
@@ -107,7 +127,7 @@ class RadioGroup : public Entity {
 
   virtual void ChildValueChanged(Entity *child);
 
-  virtual String GetTypeName() const { return kTypeNameRadioGroup; }
+  virtual TypeName GetTypeName() const { return kTypeNameRadioGroup; }
 
  protected:
   void SetSelectedIndex(size_t index);
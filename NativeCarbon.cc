@@ -130,14 +130,14 @@ Carbon::Window::~Window() {
 bool Carbon::Window::SetProperty(PropertyName name, const Value &value) {
   if (window_ref_ == NULL)
     return false;
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     ScopedCFType<CFStringRef> title(
         CFStringFromString(value.Coerce<String>()),
         kDontRetain);
     ::SetWindowTitleWithCFString(window_ref_, title);
     return true;
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     const Size size = value.Coerce<Size>();
     Rect bounds;
 
@@ -154,19 +154,19 @@ bool Carbon::Window::SetProperty(PropertyName name, const Value &value) {
 Value Carbon::Window::GetProperty(PropertyName name) const {
   if (window_ref_ == NULL)
     return false;
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     ScopedCFType<CFStringRef> title;
 
     ::CopyWindowTitleAsCFString(window_ref_, title.RetainedOutPtr());
     return StringFromCFString(title);
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     Rect bounds;
 
     ::GetWindowBounds(window_ref_, kWindowContentRgn, &bounds);
     return Size(bounds.right-bounds.left, bounds.bottom-bounds.top);
   }
-  if (strcmp(name, kPropMargins) == 0) {
+  if (name == kPropMargins) {
     return Value(Spacing(14, 20, 20, 20));
   }
   return Value();
@@ -266,13 +266,13 @@ Carbon::Control::~Control() {
 bool Carbon::Control::SetProperty(PropertyName name, const Value &value) {
   if (view_ref_ == NULL)
     return false;
-  if (strcmp(name, kPropLocation) == 0) {
+  if (name == kPropLocation) {
     const Location loc = value.Coerce<Location>() + GetViewOffset();
 
     ::HIViewPlaceInSuperviewAt(view_ref_, loc.x, loc.y);
     return true;
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     const Size size = value.Coerce<Size>() + GetInset();
     HIRect frame;
 
@@ -282,14 +282,14 @@ bool Carbon::Control::SetProperty(PropertyName name, const Value &value) {
     ::HIViewSetFrame(view_ref_, &frame);
     return true;
   }
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     ScopedCFType<CFStringRef> cf_text(
         CFStringFromString(value.Coerce<String>()),
         kDontRetain);
 
     return ::HIViewSetText(view_ref_, cf_text) == noErr;
   }
-  if (strcmp(name, kPropVisible) == 0) {
+  if (name == kPropVisible) {
     ::HIViewSetVisible(view_ref_, value.Coerce<bool>());
   }
   return false;
@@ -298,27 +298,27 @@ bool Carbon::Control::SetProperty(PropertyName name, const Value &value) {
 Value Carbon::Control::GetProperty(PropertyName name) const {
   if (view_ref_ == NULL)
     return Value();
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     ScopedCFType<CFStringRef> cf_text(::HIViewCopyText(view_ref_), kDontRetain);
 
     return StringFromCFString(cf_text);
   }
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     HIRect bounds;
 
     ::HIViewGetOptimalBounds(view_ref_, &bounds, NULL);
     return Size(bounds.size.width, bounds.size.height) - GetInset();
   }
-  if (strcmp(name, kPropLocation) == 0) {
+  if (name == kPropLocation) {
     HIRect frame;
 
     ::HIViewGetFrame(view_ref_, &frame);
     return Location(frame.origin.x, frame.origin.y) - GetViewOffset();
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     return GetSize() - GetInset();
   }
-  if (strcmp(name, kPropVisible) == 0) {
+  if (name == kPropVisible) {
     return (bool)::HIViewIsVisible(view_ref_);
   }
   return Value();
@@ -349,7 +349,7 @@ bool Carbon::Button::SetProperty(PropertyName name, const Value &value) {
 }
 
 Value Carbon::Button::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     return Spacing(12, 12, 12, 12);
   }
   return Control::GetProperty(name);
@@ -382,10 +382,10 @@ void Carbon::Label::InitializeProperties(const PropertyMap &properties) {
 }
 
 Value Carbon::Label::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     return Spacing(8, 8, 8, 8);
   }
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     float wrap_width = 0;
     bool variable = false;
 
@@ -455,7 +455,7 @@ void Carbon::Separator::Finalize() {
 }
 
 Value Carbon::Separator::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     return Size(1, 1);
   }
   return Control::GetProperty(name);
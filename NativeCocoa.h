@@ -68,11 +68,12 @@ class Cocoa {
     virtual void InitializeProperties(const PropertyMap &properties);
     WindowInterface* GetWindowInterface() { return this; }
 
-    virtual String GetTypeName() const { return kTypeNameWindow; }
+    virtual TypeName GetTypeName() const { return kTypeNameWindow; }
 
     virtual bool SetProperty(PropertyName name, const Value &value);
     virtual Value GetProperty(PropertyName name) const;
     virtual void AddChild(Native *child);
+    virtual void CommitGeometry(const Array<GeometryChange> &changes);
 
     void* GetNativeRef() { return window_ref_; }
 
@@ -127,7 +128,7 @@ class Cocoa {
     Box() {}
 
     virtual void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameBox; }
+    virtual TypeName GetTypeName() const { return kTypeNameBox; }
     virtual Value GetProperty(PropertyName name) const;
     virtual Spacing GetInset() const;
     // Adds children as subviews
@@ -171,7 +172,7 @@ class Cocoa {
 
     virtual void InitializeProperties(const PropertyMap &properties);
 
-    virtual String GetTypeName() const { return kTypeNameButton; }
+    virtual TypeName GetTypeName() const { return kTypeNameButton; }
 
     virtual bool SetProperty(PropertyName name, const Value &value);
     virtual Value GetProperty(PropertyName name) const;
@@ -201,7 +202,7 @@ class Cocoa {
 
     virtual Value GetProperty(PropertyName name) const;
 
-    virtual String GetTypeName() const { return kTypeNameCheck; }
+    virtual TypeName GetTypeName() const { return kTypeNameCheck; }
 
    protected:
     Spacing GetInset() const { return Spacing(-2, -2, -2, 0); }
@@ -215,7 +216,7 @@ class Cocoa {
 
     virtual Value GetProperty(PropertyName name) const;
 
-    virtual String GetTypeName() const { return kTypeNameRadio; }
+    virtual TypeName GetTypeName() const { return kTypeNameRadio; }
 
    protected:
     Spacing GetInset() const;
@@ -228,7 +229,7 @@ class Cocoa {
     Label();
 
     virtual void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameLabel; }
+    virtual TypeName GetTypeName() const { return kTypeNameLabel; }
     virtual Value GetProperty(PropertyName name) const;
     virtual bool SetProperty(PropertyName name, const Value &value);
     virtual void Finalize();
@@ -248,7 +249,7 @@ class Cocoa {
     Link() {}
 
     void InitializeProperties(const PropertyMap &properties);
-    String GetTypeName() const { return kTypeNameLink; }
+    TypeName GetTypeName() const { return kTypeNameLink; }
     bool SetProperty(PropertyName name, const Value &value);
 
     void SetURL(const String &url);
@@ -260,7 +261,7 @@ class Cocoa {
     EditField() {}
 
     void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameEdit; }
+    virtual TypeName GetTypeName() const { return kTypeNameEdit; }
     Value GetProperty(PropertyName name) const;
     bool SetProperty(PropertyName name, const Value &value);
 
@@ -273,7 +274,7 @@ class Cocoa {
    public:
     PasswordField() {}
 
-    virtual String GetTypeName() const { return kTypeNamePassword; }
+    virtual TypeName GetTypeName() const { return kTypeNamePassword; }
 
    protected:
     virtual Class GetTextFieldClass();
@@ -285,7 +286,7 @@ class Cocoa {
     PathBox() {}
 
     void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNamePath; }
+    virtual TypeName GetTypeName() const { return kTypeNamePath; }
     Value GetProperty(PropertyName name) const;
     bool SetProperty(PropertyName name, const Value &value);
   };
@@ -296,7 +297,7 @@ class Cocoa {
     Separator() {}
 
     virtual void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameSeparator; }
+    virtual TypeName GetTypeName() const { return kTypeNameSeparator; }
     virtual void Finalize();
     virtual Value GetProperty(PropertyName name) const;
   };
@@ -307,7 +308,7 @@ class Cocoa {
     Image() {}
 
     virtual void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameImage; }
+    virtual TypeName GetTypeName() const { return kTypeNameImage; }
     virtual Value GetProperty(PropertyName name) const;
   };
 
@@ -317,7 +318,7 @@ class Cocoa {
     AppIcon() {}
 
     virtual void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameAppIcon; }
+    virtual TypeName GetTypeName() const { return kTypeNameAppIcon; }
     virtual Value GetProperty(PropertyName name) const;
   };
 
@@ -327,7 +328,7 @@ class Cocoa {
     Popup() {}
 
     void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNamePopup; }
+    virtual TypeName GetTypeName() const { return kTypeNamePopup; }
     void AddChild(Native *child);
     Value GetProperty(PropertyName name) const;
     bool SetProperty(PropertyName name, const Value &value);
@@ -341,7 +342,7 @@ class Cocoa {
     PopupItem() : item_(NULL) {}
 
     void InitializeProperties(const PropertyMap &properties);
-    String GetTypeName() const { return kTypeNameItem; }
+    TypeName GetTypeName() const { return kTypeNameItem; }
     void* GetNativeRef() { return item_; }
     bool SetProperty(PropertyName name, const Value &value);
     Value GetProperty(PropertyName name) const;
@@ -358,7 +359,7 @@ class Cocoa {
     Slider() {}
 
     void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameSlider; }
+    virtual TypeName GetTypeName() const { return kTypeNameSlider; }
     Value GetProperty(PropertyName name) const;
     bool SetProperty(PropertyName name, const Value &value);
 
@@ -372,7 +373,7 @@ class Cocoa {
     ~List();
 
     virtual void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameList; }
+    virtual TypeName GetTypeName() const { return kTypeNameList; }
     virtual void AddChild(Native *child);
     virtual bool SetProperty(PropertyName name, const Value &value);
     virtual Value GetProperty(PropertyName name) const;
@@ -393,7 +394,7 @@ class Cocoa {
     ListColumn();
 
     virtual void InitializeProperties(const PropertyMap &properties);
-    virtual String GetTypeName() const { return kTypeNameColumn; }
+    virtual TypeName GetTypeName() const { return kTypeNameColumn; }
     virtual void* GetNativeRef() { return column_ref_; }
     virtual bool SetProperty(PropertyName name, const Value &value);
     virtual Value GetProperty(PropertyName name) const;
@@ -478,11 +478,11 @@ bool Cocoa::Window::SetProperty(PropertyName name, const Value &value) {
 
   if (window_ref_ == nil)
     return false;
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     [window_ref_ setTitle:NSStringWithString(value.Coerce<String>())];
     return true;
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     NSRect content = [NSWindow
         contentRectForFrameRect:[window_ref_ frame]
         styleMask:[window_ref_ styleMask]];
@@ -499,7 +499,7 @@ bool Cocoa::Window::SetProperty(PropertyName name, const Value &value) {
     [window_ref_ setFrame:frame display:YES];
     return true;
   }
-  if (strcmp(name, kPropLocation) == 0) {
+  if (name == kPropLocation) {
     const NSRect screen_frame = [[window_ref_ screen] frame];
     const Location location = value.Coerce<Location>();
 
@@ -514,20 +514,20 @@ Value Cocoa::Window::GetProperty(PropertyName name) const {
 
   if (window_ref_ == nil)
     return false;
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     NSString *title = [window_ref_ title];
 
     return String([title UTF8String]);
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     NSRect content_rect = [[window_ref_ contentView] frame];
 
     return Size(content_rect.size.width, content_rect.size.height);
   }
-  if (strcmp(name, kPropMargins) == 0) {
+  if (name == kPropMargins) {
     return Value(Spacing(14, 20, 20, 20));
   }
-  if (strcmp(name, kPropVisible) == 0) {
+  if (name == kPropVisible) {
     return Value((bool)[window_ref_ isVisible]);
   }
   return Value();
@@ -543,6 +543,15 @@ void Cocoa::Window::AddChild(Native *child) {
   [[window_ref_ contentView] addSubview:child_view];
 }
 
+void Cocoa::Window::CommitGeometry(const Array<GeometryChange> &changes) {
+  ScopedAutoreleasePool pool;
+
+  // Keep the window from redrawing with only some of the views moved.
+  NSDisableScreenUpdates();
+  ApplyGeometry(changes);
+  NSEnableScreenUpdates();
+}
+
 bool Cocoa::Window::ShowModeless() {
   ScopedAutoreleasePool pool;
 
@@ -617,7 +626,7 @@ bool Cocoa::View::SetProperty(PropertyName name, const Value &value) {
 
   if (view_ref_ == NULL)
     return false;
-  if (strcmp(name, kPropLocation) == 0) {
+  if (name == kPropLocation) {
     const Spacing inset = GetInset();
     const Location offset = GetViewOffset();
     const Location set_loc = value.Coerce<Location>();
@@ -633,7 +642,7 @@ bool Cocoa::View::SetProperty(PropertyName name, const Value &value) {
 #endif
     return true;
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     const Size size = value.Coerce<Size>() - GetInset();
     NSRect frame = [view_ref_ frame];
 
@@ -645,7 +654,7 @@ bool Cocoa::View::SetProperty(PropertyName name, const Value &value) {
     [view_ref_ setNeedsDisplay:YES];
     return true;
   }
-  if (strcmp(name, kPropVisible) == 0) {
+  if (name == kPropVisible) {
     [view_ref_ setHidden:!value.Coerce<bool>()];
     [[view_ref_ superview] setNeedsDisplayInRect:[view_ref_ frame]];
     return true;
@@ -658,13 +667,13 @@ Value Cocoa::View::GetProperty(PropertyName name) const {
 
   if (view_ref_ == nil)
     return Value();
-  if (strcmp(name, kPropLocation) == 0) {
+  if (name == kPropLocation) {
     return GetLocation();
   }
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     return GetViewSize() + GetInset();
   }
-  if (strcmp(name, kPropVisible) == 0) {
+  if (name == kPropVisible) {
     return (bool)![view_ref_ isHidden];
   }
   return Value();
@@ -698,11 +707,11 @@ void Cocoa::Box::InitializeProperties(const PropertyMap &properties) {
 }
 
 Value Cocoa::Box::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropMargins) == 0) {
+  if (name == kPropMargins) {
     // AHIG: 10, 16, 16, 16  IB: 11, 16, 11, 16
     return Spacing(10, 16, 16, 16);
   }
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // AHIG: no recommendation  IB: 8, seems too small
     return Spacing(12, 12, 12, 12);
   }
@@ -728,20 +737,20 @@ Location Cocoa::Box::GetSubviewAdjustment() const {
 }
 
 bool Cocoa::Control::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     ScopedAutoreleasePool pool;
 
     [(NSControl*)view_ref_ setStringValue:
         NSStringWithString(value.Coerce<String>())];
     return true;
   }
-  if (strcmp(name, kPropEnabled) == 0) {
+  if (name == kPropEnabled) {
     ScopedAutoreleasePool pool;
 
     [(NSControl*)view_ref_ setEnabled:value.Coerce<bool>()];
     return true;
   }
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     [(NSControl*)view_ref_ setIntValue:value.Coerce<int32_t>()];
     return true;
   }
@@ -754,7 +763,7 @@ static const NSSize kMaxCellSize = { 10000, 10000 };
 Value Cocoa::Control::GetProperty(PropertyName name) const {
   ScopedAutoreleasePool pool;
 
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     const NSSize cell_size = [[(NSControl*)view_ref_ cell] cellSize];
 
     if (NSEqualSizes(cell_size, NSZeroSize) ||
@@ -763,15 +772,15 @@ Value Cocoa::Control::GetProperty(PropertyName name) const {
 
     return Size(cell_size.width, cell_size.height) + GetInset();
   }
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     NSString *text = [(NSControl*)view_ref_ stringValue];
 
     return String([text UTF8String]);
   }
-  if (strcmp(name, kPropEnabled) == 0) {
+  if (name == kPropEnabled) {
     return static_cast<bool>([(NSControl*)view_ref_ isEnabled]);
   }
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     return static_cast<int32_t>([(NSControl*)view_ref_ intValue]);
   }
   return View::GetProperty(name);
@@ -786,11 +795,11 @@ Cocoa::Button::~Button() {
 }
 
 bool Cocoa::Button::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     [(NSButton*)view_ref_ setTitle:NSStringWithString(value.Coerce<String>())];
     return true;
   }
-  if (strcmp(name, kPropUISize) == 0) {
+  if (name == kPropUISize) {
     const String ui_size = value.Coerce<String>();
     NSControlSize size = NSRegularControlSize;
     NSCell *cell = [(NSButton*)view_ref_ cell];
@@ -827,7 +836,7 @@ void Cocoa::PushButton::InitializeProperties(const PropertyMap &properties) {
 bool Cocoa::PushButton::SetProperty(PropertyName name, const Value &value) {
   ScopedAutoreleasePool pool;
 
-  if (strcmp(name, kPropButtonType) == 0) {
+  if (name == kPropButtonType) {
     const String type = value.Coerce<String>();
 
     if (type == kButtonTypeNameDefault)
@@ -845,7 +854,7 @@ bool Cocoa::PushButton::SetProperty(PropertyName name, const Value &value) {
 Value Cocoa::PushButton::GetProperty(PropertyName name) const {
   ScopedAutoreleasePool pool;
 
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     Size min_size = Control::GetProperty(kPropMinimumSize).Coerce<Size>();
 
     // cellSize returns 32 instead of 20, so correct it
@@ -856,7 +865,7 @@ Value Cocoa::PushButton::GetProperty(PropertyName name) const {
     min_size.width += kButtonWidthAdjustment;
     return min_size;
   }
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // AHIG and IB agree on 12/10/8
     switch ([[(NSButton*)view_ref_ cell] controlSize]) {
       case NSRegularControlSize:
@@ -869,12 +878,12 @@ Value Cocoa::PushButton::GetProperty(PropertyName name) const {
         return Value();
     }
   }
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     NSString *text = [(NSButton*)view_ref_ title];
 
     return String([text cStringUsingEncoding:NSUTF8StringEncoding]);
   }
-  if (strcmp(name, kPropBaseline) == 0) {
+  if (name == kPropBaseline) {
     if ([[(NSButton*)view_ref_ cell] controlSize] == NSSmallControlSize)
       return 13;
     else
@@ -911,7 +920,7 @@ void Cocoa::ValueButton::Finalize() {
 }
 
 bool Cocoa::ValueButton::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     const NSCellStateValue new_state = value.Coerce<bool>() ?
         NSOnState : NSOffState;
     const NSCellStateValue old_state = [(NSButton*)view_ref_ state];
@@ -924,7 +933,7 @@ bool Cocoa::ValueButton::SetProperty(PropertyName name, const Value &value) {
 }
 
 Value Cocoa::ValueButton::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     ScopedAutoreleasePool pool;
 
     return static_cast<int32_t>([(NSButton*)view_ref_ state]);
@@ -935,7 +944,7 @@ Value Cocoa::ValueButton::GetProperty(PropertyName name) const {
 Value Cocoa::Checkbox::GetProperty(PropertyName name) const {
   ScopedAutoreleasePool pool;
 
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // AHIG recommends 8 pixels for normal/small, but Interface Builder uses 6.
     if ([[(NSButton*)view_ref_ cell] controlSize] == NSMiniControlSize)
       return Spacing(5, 5, 5, 5);
@@ -950,7 +959,7 @@ NSButtonType Cocoa::Checkbox::GetButtonType() const {
 }
 
 Value Cocoa::Radio::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     ScopedAutoreleasePool pool;
 
     // AHIG and IB agree on 6 and 5.
@@ -959,7 +968,7 @@ Value Cocoa::Radio::GetProperty(PropertyName name) const {
     else  // regular and small
       return Spacing(6, 6, 6, 6);
   }
-  if (strcmp(name, kPropBaseline) == 0) {
+  if (name == kPropBaseline) {
     switch ([[(NSButton*)view_ref_ cell] controlSize]) {
       case NSMiniControlSize:
         return 9;
@@ -1054,7 +1063,7 @@ static float HeightForText(NSString *text, NSFont *font, float width) {
 Value Cocoa::Label::GetProperty(PropertyName name) const {
   ScopedAutoreleasePool pool;
 
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // AHIG recommends 8/6/5, IB uses 8
     switch ([[(NSControl*)view_ref_ cell] controlSize]) {
       case NSRegularControlSize:
@@ -1067,7 +1076,7 @@ Value Cocoa::Label::GetProperty(PropertyName name) const {
         return Value();
     }
   }
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     Layout *layout = entity_->GetLayout();
 
     if (layout == NULL)
@@ -1089,7 +1098,7 @@ Value Cocoa::Label::GetProperty(PropertyName name) const {
     }
     return text_size + GetInset();
   }
-  if (strcmp(name, kPropBaseline) == 0) {
+  if (name == kPropBaseline) {
     switch (ui_size_) {
       case NSSmallControlSize:   return 11;
       case NSMiniControlSize:    return 9;
@@ -1101,7 +1110,7 @@ Value Cocoa::Label::GetProperty(PropertyName name) const {
 }
 
 bool Cocoa::Label::SetProperty(const PropertyName name, const Value &value) {
-  if (strcmp(name, kPropSize) == 0) {
+  if (name == kPropSize) {
     if (entity_->GetLayout()->GetHSizeOption() == kSizeFill) {
       const NSSize old_size = [view_ref_ bounds].size;
 
@@ -1113,7 +1122,7 @@ bool Cocoa::Label::SetProperty(const PropertyName name, const Value &value) {
       return Control::SetProperty(name, value);
     }
   }
-  if (strcmp(name, kPropUISize) == 0) {
+  if (name == kPropUISize) {
     const String size = value.Coerce<String>();
 
     if (size == kUISizeSmall)
@@ -1123,7 +1132,7 @@ bool Cocoa::Label::SetProperty(const PropertyName name, const Value &value) {
     UpdateFont();
     return true;
   }
-  if (strcmp(name, kPropStyle) == 0) {
+  if (name == kPropStyle) {
     heading_ = (value.Coerce<String>() == kLabelStyleNameHead);
     UpdateFont();
     return true;
@@ -1162,7 +1171,7 @@ void Cocoa::Link::InitializeProperties(const PropertyMap &properties) {
 }
 
 bool Cocoa::Link::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropURL) == 0) {
+  if (name == kPropURL) {
     SetURL(value.Coerce<String>());
     return true;
   }
@@ -1203,11 +1212,11 @@ Class Cocoa::EditField::GetTextFieldClass() {
 }
 
 Value Cocoa::EditField::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // AHIG and IB agree
     return Spacing(10, 8, 10, 8);
   }
-  if (strcmp(name, kPropBaseline) == 0) {
+  if (name == kPropBaseline) {
     return 16;
   }
   return Control::GetProperty(name);
@@ -1216,7 +1225,7 @@ Value Cocoa::EditField::GetProperty(PropertyName name) const {
 bool Cocoa::EditField::SetProperty(PropertyName name, const Value &value) {
   ScopedAutoreleasePool pool;
 
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     [(NSTextField*)view_ref_ setStringValue:
         NSStringWithString(value.Coerce<String>())];
     return true;
@@ -1236,17 +1245,17 @@ void Cocoa::PathBox::InitializeProperties(const PropertyMap &properties) {
 }
 
 Value Cocoa::PathBox::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // Use same as edit field
     return Spacing(10, 8, 10, 8);
   }
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     return Size(20, 20);
   }
-  if (strcmp(name, kPropBaseline) == 0) {
+  if (name == kPropBaseline) {
     return 15;
   }
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     return String([[(PathBoxControl*)view_ref_ path] UTF8String]);
   }
   return View::GetProperty(name);
@@ -1255,7 +1264,7 @@ Value Cocoa::PathBox::GetProperty(PropertyName name) const {
 bool Cocoa::PathBox::SetProperty(PropertyName name, const Value &value) {
   ScopedAutoreleasePool pool;
 
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     [(PathBoxControl*)view_ref_ setPath:
         NSStringWithString(value.Coerce<String>())];
     return true;
@@ -1283,10 +1292,10 @@ void Cocoa::Separator::Finalize() {
 }
 
 Value Cocoa::Separator::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     return Size(2, 2);
   }
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     Layout *layout = entity_->GetLayout();
 
     if (layout == NULL)
@@ -1316,7 +1325,7 @@ void Cocoa::Image::InitializeProperties(const PropertyMap &properties) {
 }
 
 Value Cocoa::Image::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     if ([(NSImageView*)view_ref_ image] == nil)
       return Size(20, 20);
 
@@ -1336,10 +1345,10 @@ void Cocoa::AppIcon::InitializeProperties(const PropertyMap &properties) {
 }
 
 Value Cocoa::AppIcon::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     return Value(Size(64, 64));
   }
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // In the standard NSAlert nib, the icon has 19px space on the right
     // and 12px on the bottom.
     return Value(Spacing(12, 19, 12, 19));
@@ -1358,7 +1367,7 @@ void Cocoa::Popup::InitializeProperties(const PropertyMap &properties) {
 }
 
 bool Cocoa::Popup::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     const NSInteger
         old_selection = [(NSPopUpButton*)view_ref_ indexOfSelectedItem],
         new_selection = value.Coerce<int32_t>();
@@ -1372,7 +1381,7 @@ bool Cocoa::Popup::SetProperty(PropertyName name, const Value &value) {
 }
 
 Value Cocoa::Popup::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // Using AHIG spacing.
     switch ([[(NSControl*)view_ref_ cell] controlSize]) {
       case NSRegularControlSize:
@@ -1385,10 +1394,10 @@ Value Cocoa::Popup::GetProperty(PropertyName name) const {
         return Value();
     }
   }
-  if (strcmp(name, kPropBaseline) == 0) {
+  if (name == kPropBaseline) {
     return 15;  // depending on UI size
   }
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     return Value(static_cast<uint32_t>(
         [(NSPopUpButton*)view_ref_ indexOfSelectedItem]));
   }
@@ -1417,7 +1426,7 @@ void Cocoa::PopupItem::InitializeProperties(const PropertyMap &properties) {
 }
 
 bool Cocoa::PopupItem::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropEnabled) == 0) {
+  if (name == kPropEnabled) {
     ScopedAutoreleasePool pool;
 
     [item_ setEnabled:value.Coerce<bool>()];
@@ -1427,7 +1436,7 @@ bool Cocoa::PopupItem::SetProperty(PropertyName name, const Value &value) {
 }
 
 Value Cocoa::PopupItem::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropEnabled) == 0) {
+  if (name == kPropEnabled) {
     ScopedAutoreleasePool pool;
     return (bool)[item_ isEnabled];
   }
@@ -1442,19 +1451,19 @@ void Cocoa::Slider::InitializeProperties(const PropertyMap &properties) {
 }
 
 bool Cocoa::Slider::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     [(NSSlider*)view_ref_ setFloatValue:value.Coerce<double>()];
     return true;
   }
-  if (strcmp(name, kPropMin) == 0) {
+  if (name == kPropMin) {
     [(NSSlider*)view_ref_ setMinValue:value.Coerce<double>()];
     return true;
   }
-  if (strcmp(name, kPropMax) == 0) {
+  if (name == kPropMax) {
     [(NSSlider*)view_ref_ setMaxValue:value.Coerce<double>()];
     return true;
   }
-  if (strcmp(name, kPropTicks) == 0) {
+  if (name == kPropTicks) {
     [(NSSlider*)view_ref_ setNumberOfTickMarks:value.Coerce<uint32_t>()];
     return true;
   }
@@ -1462,7 +1471,7 @@ bool Cocoa::Slider::SetProperty(PropertyName name, const Value &value) {
 }
 
 Value Cocoa::Slider::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropPadding) == 0) {
+  if (name == kPropPadding) {
     // AHIG says 12/10/8, IB uses 8
     switch ([[(NSButton*)view_ref_ cell] controlSize]) {
       case NSRegularControlSize:
@@ -1475,15 +1484,15 @@ Value Cocoa::Slider::GetProperty(PropertyName name) const {
         return Value();
     }
   }
-  if (strcmp(name, kPropValue) == 0)
+  if (name == kPropValue)
     return [(NSSlider*)view_ref_ floatValue];
-  if (strcmp(name, kPropMin) == 0)
+  if (name == kPropMin)
     return [(NSSlider*)view_ref_ minValue];
-  if (strcmp(name, kPropMax) == 0)
+  if (name == kPropMax)
     return [(NSSlider*)view_ref_ maxValue];
-  if (strcmp(name, kPropTicks) == 0)
+  if (name == kPropTicks)
     return [(NSSlider*)view_ref_ numberOfTickMarks];
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     // NSSlider claims its ideal width is 40000.
     const NSSize cell_size = [[(NSControl*)view_ref_ cell] cellSize];
 
@@ -1537,20 +1546,20 @@ void Cocoa::List::AddChild(Native *child) {
 }
 
 bool Cocoa::List::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropEnabled) == 0) {
+  if (name == kPropEnabled) {
     ScopedAutoreleasePool pool;
 
     [table_view_ setEnabled:value.Coerce<bool>()];
     return true;
   }
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     ScopedAutoreleasePool pool;
     NSIndexSet *index = [NSIndexSet indexSetWithIndex:value.Coerce<int32_t>()];
 
     [table_view_ selectRowIndexes:index byExtendingSelection:NO];
     return true;
   }
-  if (strcmp(name, kPropRowCount) == 0) {
+  if (name == kPropRowCount) {
     // On Windows, the row count is stored by the control, even when data
     // callbacks are used. We emulate that here for consistency.
     ScopedAutoreleasePool pool;
@@ -1559,7 +1568,7 @@ bool Cocoa::List::SetProperty(PropertyName name, const Value &value) {
     [table_view_ reloadData];
     return true;
   }
-  if (strcmp(name, kPropData) == 0) {
+  if (name == kPropData) {
     if (value.IsValid())
       data_ = value.Coerce<ListDataInterface*>();
     else
@@ -1575,7 +1584,7 @@ const CGFloat kRowHeightFudge = 2;
 const CGFloat kColumnWidthFudge = 3;
 
 Value Cocoa::List::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     NSScrollView *scroll = (NSScrollView*)view_ref_;
     NSSize size = NSZeroSize;
     ExplicitSize explicit_size = entity_->GetLayout()->GetExplicitSize();
@@ -1599,12 +1608,12 @@ Value Cocoa::List::GetProperty(PropertyName name) const {
 
     return Size(frameSize.width, frameSize.height) + GetInset();
   }
-  if (strcmp(name, kPropEnabled) == 0) {
+  if (name == kPropEnabled) {
     ScopedAutoreleasePool pool;
 
     return static_cast<bool>([table_view_ isEnabled]);
   }
-  if (strcmp(name, kPropValue) == 0) {
+  if (name == kPropValue) {
     ScopedAutoreleasePool pool;
 
     return static_cast<int32_t>([table_view_ selectedRow]);
@@ -1624,17 +1633,17 @@ void Cocoa::ListColumn::InitializeProperties(const PropertyMap &properties) {
 }
 
 bool Cocoa::ListColumn::SetProperty(PropertyName name, const Value &value) {
-  if (strcmp(name, kPropWidthOption) == 0) {
+  if (name == kPropWidthOption) {
     size_.ParseWidth(value.Coerce<String>());
     [column_ref_ setWidth:size_.CalculateWidth(GetPlatformMetrics())];
     return true;
   }
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     [[column_ref_ headerCell]
         setTitle:NSStringWithString(value.Coerce<String>())];
     return true;
   }
-  if (strcmp(name, kPropColumnType) == 0) {
+  if (name == kPropColumnType) {
     // Default is text.
     if (value.Coerce<String>() == kColumnTypeNameCheck) {
       NSButtonCell *cell = [[[NSButtonCell alloc] init] autorelease];
@@ -1645,7 +1654,7 @@ bool Cocoa::ListColumn::SetProperty(PropertyName name, const Value &value) {
       [column_ref_ setDataCell:cell];
     }
   }
-  if (strcmp(name, kPropAlign) == 0) {
+  if (name == kPropAlign) {
     const String align_string = value.Coerce<String>();
     NSTextAlignment alignment = NSNaturalTextAlignment;
 
@@ -1663,12 +1672,12 @@ bool Cocoa::ListColumn::SetProperty(PropertyName name, const Value &value) {
 }
 
 Value Cocoa::ListColumn::GetProperty(PropertyName name) const {
-  if (strcmp(name, kPropText) == 0) {
+  if (name == kPropText) {
     ScopedAutoreleasePool pool;
 
     return String([[[column_ref_ headerCell] stringValue] UTF8String]);
   }
-  if (strcmp(name, kPropMinimumSize) == 0) {
+  if (name == kPropMinimumSize) {
     return Size(size_.CalculateWidth(GetPlatformMetrics()), 0);
   }
   return NativeCocoa::GetProperty(name);
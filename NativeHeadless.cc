@@ -0,0 +1,492 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/NativeHeadless.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+
+#include "Diadem/Factory.h"
+#include "Diadem/Layout.h"
+
+namespace Diadem {
+
+namespace {
+
+const Headless::FixedWidthMeasurer default_measurer;
+
+// Holds the calling thread's innermost ThreadSettings.
+pthread_key_t settings_key;
+pthread_once_t settings_key_once = PTHREAD_ONCE_INIT;
+
+void CreateSettingsKey() {
+  pthread_key_create(&settings_key, NULL);
+}
+
+}  // namespace
+
+// The same as Cocoa, so that layouts come out close to the Mac ones.
+PlatformMetrics Headless::metrics_ = {
+    14, 17, 18,
+    Spacing(12, 6, 12, 6) };
+
+const Headless::TextMeasurer *Headless::measurer_ = &default_measurer;
+
+void Headless::SetUpFactory(Factory *factory) {
+  DASSERT(factory != NULL);
+  factory->RegisterNative<AppIcon>(kTypeNameAppIcon);
+  factory->RegisterNative<Box>(kTypeNameBox);
+  factory->RegisterNative<Checkbox>(kTypeNameCheck);
+  factory->RegisterNative<EditField>(kTypeNameEdit);
+  factory->RegisterNative<Image>(kTypeNameImage);
+  factory->RegisterNative<Label>(kTypeNameLabel);
+  factory->RegisterNative<Link>(kTypeNameLink);
+  factory->RegisterNative<PasswordField>(kTypeNamePassword);
+  factory->RegisterNative<PathBox>(kTypeNamePath);
+  factory->RegisterNative<Popup>(kTypeNamePopup);
+  factory->RegisterNative<PopupItem>(kTypeNameItem);
+  factory->RegisterNative<PushButton>(kTypeNameButton);
+  factory->RegisterNative<Radio>(kTypeNameRadio);
+  factory->RegisterNative<Separator>(kTypeNameSeparator);
+  factory->RegisterNative<Slider>(kTypeNameSlider);
+  factory->RegisterNative<Window>(kTypeNameWindow);
+}
+
+void Headless::SetTextMeasurer(const TextMeasurer *measurer) {
+  measurer_ = (measurer == NULL) ? &default_measurer : measurer;
+}
+
+Headless::ThreadSettings::ThreadSettings(
+    const PlatformMetrics *metrics, const TextMeasurer *measurer)
+    : previous_(Current()),
+      metrics_((metrics != NULL) ? metrics : &CurrentPlatformMetrics()),
+      measurer_((measurer != NULL) ? measurer : &CurrentTextMeasurer()) {
+  pthread_setspecific(settings_key, this);
+}
+
+Headless::ThreadSettings::~ThreadSettings() {
+  DASSERT(Current() == this);
+  pthread_setspecific(settings_key, previous_);
+}
+
+const Headless::ThreadSettings* Headless::ThreadSettings::Current() {
+  pthread_once(&settings_key_once, &CreateSettingsKey);
+  return static_cast<const ThreadSettings*>(
+      pthread_getspecific(settings_key));
+}
+
+const PlatformMetrics& Headless::CurrentPlatformMetrics() {
+  const ThreadSettings* const settings = ThreadSettings::Current();
+
+  return (settings == NULL) ? metrics_ : settings->GetPlatformMetrics();
+}
+
+const Headless::TextMeasurer& Headless::CurrentTextMeasurer() {
+  const ThreadSettings* const settings = ThreadSettings::Current();
+
+  return (settings == NULL) ? *measurer_ : settings->GetTextMeasurer();
+}
+
+Headless::FixedWidthMeasurer::FixedWidthMeasurer() {
+  const FontMetrics
+      regular = { 7, 17, 13 },
+      small = { 6, 14, 11 },
+      mini = { 5, 12, 9 },
+      heading = { 8, 17, 13 };
+
+  fonts_[kFontRegular] = regular;
+  fonts_[kFontSmall] = small;
+  fonts_[kFontMini] = mini;
+  fonts_[kFontHeading] = heading;
+}
+
+void Headless::FixedWidthMeasurer::SetFontMetrics(
+    Font font, const FontMetrics &metrics) {
+  DASSERT(font < kFontCount);
+  fonts_[font] = metrics;
+}
+
+Size Headless::FixedWidthMeasurer::MeasureText(
+    const char *text, Font font, int32_t wrap_width) const {
+  const FontMetrics &metrics = fonts_[font];
+  int32_t lines = 1, line_width = 0, max_width = 0;
+
+  while (*text != '\0') {
+    if (*text == '\n') {
+      max_width = std::max(max_width, line_width);
+      line_width = 0;
+      ++lines;
+      ++text;
+      continue;
+    }
+
+    // Measure the next word along with the spaces before it.
+    int32_t space_width = 0, word_width = 0;
+
+    for (; *text == ' '; ++text)
+      space_width += metrics.char_width;
+    for (; (*text != '\0') && (*text != ' ') && (*text != '\n'); ++text)
+      if ((*text & 0xC0) != 0x80)  // Skip UTF-8 continuation bytes
+        word_width += metrics.char_width;
+
+    if ((wrap_width > 0) && (line_width > 0) && (word_width > 0) &&
+        (line_width + space_width + word_width > wrap_width)) {
+      max_width = std::max(max_width, line_width);
+      line_width = word_width;
+      ++lines;
+    } else {
+      line_width += space_width + word_width;
+    }
+  }
+  max_width = std::max(max_width, line_width);
+  return Size(max_width, lines * metrics.line_height);
+}
+
+bool Headless::NativeHeadless::SetProperty(
+    PropertyName name, const Value &value) {
+  if (name == kPropSize) {
+    size_ = value.Coerce<Size>();
+    return true;
+  }
+  if (name == kPropLocation) {
+    location_ = value.Coerce<Location>() + GetViewOffset();
+    return true;
+  }
+  if (name == kPropVisible) {
+    visible_ = value.Coerce<bool>();
+    return true;
+  }
+  if (name == kPropEnabled) {
+    enabled_ = value.Coerce<bool>();
+    return true;
+  }
+  return false;
+}
+
+Value Headless::NativeHeadless::GetProperty(PropertyName name) const {
+  if (name == kPropSize)
+    return size_;
+  if (name == kPropLocation)
+    return location_ - GetViewOffset();
+  if (name == kPropVisible)
+    return visible_;
+  if (name == kPropEnabled)
+    return enabled_;
+  return Value();
+}
+
+bool Headless::Window::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropText) {
+    title_ = value.Coerce<String>();
+    return true;
+  }
+  if (name == kPropStyle) {
+    style_ = ParseWindowStyle(value.Coerce<String>());
+    return true;
+  }
+  return NativeHeadless::SetProperty(name, value);
+}
+
+Value Headless::Window::GetProperty(PropertyName name) const {
+  if (name == kPropText)
+    return title_;
+  if (name == kPropMargins)
+    return Spacing(14, 20, 20, 20);
+  return NativeHeadless::GetProperty(name);
+}
+
+bool Headless::Window::ShowModeless() {
+  visible_ = true;
+  return true;
+}
+
+bool Headless::Window::Close() {
+  visible_ = false;
+  return true;
+}
+
+bool Headless::Window::SetFocus(Entity *new_focus) {
+  if (new_focus->GetNative() == NULL)
+    return false;
+  focus_ = new_focus;
+  return true;
+}
+
+bool Headless::Window::TestClose() {
+  Diadem::Window* const window = entity_->GetWindow();
+
+  if ((window == NULL) || window->AttemptClose())
+    Close();
+  return true;
+}
+
+Value Headless::Box::GetProperty(PropertyName name) const {
+  if (name == kPropMargins)
+    return Spacing(10, 16, 16, 16);
+  if (name == kPropPadding)
+    return Spacing(12, 12, 12, 12);
+  return NativeHeadless::GetProperty(name);
+}
+
+bool Headless::Control::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropText) {
+    text_ = value.Coerce<String>();
+    return true;
+  }
+  if (name == kPropUISize) {
+    const String ui_size = value.Coerce<String>();
+
+    if (ui_size == kUISizeSmall)
+      font_ = kFontSmall;
+    else if (ui_size == kUISizeMini)
+      font_ = kFontMini;
+    else
+      font_ = kFontRegular;
+    return true;
+  }
+  if (name == kPropValue) {
+    value_ = value.Coerce<int32_t>();
+    return true;
+  }
+  return NativeHeadless::SetProperty(name, value);
+}
+
+Value Headless::Control::GetProperty(PropertyName name) const {
+  if (name == kPropMinimumSize)
+    return GetMinimumSize();
+  if (name == kPropPadding)
+    return GetPadding();
+  if (name == kPropBaseline)
+    return GetFrame().top + text_measurer_->GetBaseline(font_);
+  if (name == kPropText)
+    return text_;
+  if (name == kPropValue)
+    return value_;
+  return NativeHeadless::GetProperty(name);
+}
+
+Size Headless::Control::GetMinimumSize() const {
+  return text_measurer_->MeasureText(text_.Get(), font_, 0) + GetFrame();
+}
+
+int32_t Headless::Control::ForUISize(
+    int32_t regular, int32_t small, int32_t mini) const {
+  switch (font_) {
+    case kFontSmall: return small;
+    case kFontMini:  return mini;
+    default:         return regular;
+  }
+}
+
+void Headless::Control::ChangeValue(int32_t value) {
+  if (value == value_)
+    return;
+  value_ = value;
+  entity_->PropertyChanged(kPropValue);
+}
+
+bool Headless::PushButton::SetProperty(PropertyName name, const Value &value) {
+  // Default and cancel buttons only matter for keyboard handling.
+  if (name == kPropButtonType)
+    return true;
+  return Control::SetProperty(name, value);
+}
+
+Spacing Headless::PushButton::GetFrame() const {
+  const int32_t side = ForUISize(14, 10, 8);
+
+  return Spacing(2, side, ForUISize(2, 2, 1), side);
+}
+
+Spacing Headless::PushButton::GetPadding() const {
+  const int32_t padding = ForUISize(12, 10, 8);
+
+  return Spacing(padding, padding, padding, padding);
+}
+
+bool Headless::Checkbox::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropValue) {
+    ChangeValue(value.Coerce<bool>() ? 1 : 0);
+    return true;
+  }
+  return Control::SetProperty(name, value);
+}
+
+// The left side has room for the box.
+Spacing Headless::Checkbox::GetFrame() const {
+  return Spacing(1, ForUISize(20, 17, 15), 1, 2);
+}
+
+Spacing Headless::Checkbox::GetPadding() const {
+  const int32_t padding = ForUISize(6, 6, 5);
+
+  return Spacing(padding, padding, padding, padding);
+}
+
+bool Headless::Label::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropStyle) {
+    font_ = (value.Coerce<String>() == kLabelStyleNameHead) ?
+        kFontHeading : kFontRegular;
+    return true;
+  }
+  if (name == kPropSize) {
+    // The height of a wrapping label depends on its width.
+    Layout* const layout = entity_->GetLayout();
+    const int32_t old_width = size_.width;
+
+    Control::SetProperty(name, value);
+    if ((layout != NULL) && (layout->GetHSizeOption() == kSizeFill) &&
+        (size_.width != old_width))
+      layout->InvalidateLayout();
+    return true;
+  }
+  return Control::SetProperty(name, value);
+}
+
+// A label that fills its width can be as narrow as its longest word.
+Size Headless::Label::GetMinimumSize() const {
+  const Layout* const layout = entity_->GetLayout();
+
+  if ((layout == NULL) || (layout->GetHSizeOption() != kSizeFill))
+    return Control::GetMinimumSize();
+
+  const int32_t min_width =
+      text_measurer_->MeasureText(text_.Get(), font_, 1).width;
+  const int32_t wrap_width = std::max(size_.width, min_width);
+
+  return Size(
+      min_width,
+      text_measurer_->MeasureText(text_.Get(), font_, wrap_width).height);
+}
+
+bool Headless::Link::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropURL) {
+    url_ = value.Coerce<String>();
+    return true;
+  }
+  return Label::SetProperty(name, value);
+}
+
+Value Headless::Link::GetProperty(PropertyName name) const {
+  if (name == kPropURL)
+    return url_;
+  return Label::GetProperty(name);
+}
+
+void Headless::Popup::AddChild(Native *child) {
+  items_.push_back(child);
+}
+
+bool Headless::Popup::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropValue) {
+    ChangeValue(value.Coerce<int32_t>());
+    return true;
+  }
+  return Control::SetProperty(name, value);
+}
+
+Spacing Headless::Popup::GetPadding() const {
+  const int32_t vertical = ForUISize(10, 8, 6);
+  const int32_t horizontal = ForUISize(8, 6, 5);
+
+  return Spacing(vertical, horizontal, vertical, horizontal);
+}
+
+Size Headless::Popup::GetMinimumSize() const {
+  Size text_size = text_measurer_->MeasureText("", font_, 0);
+
+  for (size_t i = 0; i < items_.size(); ++i) {
+    const String item_text = items_[i]->GetProperty(kPropText).Coerce<String>();
+
+    text_size.width = std::max(
+        text_size.width,
+        text_measurer_->MeasureText(item_text.Get(), font_, 0).width);
+  }
+  return text_size + GetFrame();
+}
+
+bool Headless::PopupItem::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropText) {
+    text_ = value.Coerce<String>();
+    return true;
+  }
+  return NativeHeadless::SetProperty(name, value);
+}
+
+Value Headless::PopupItem::GetProperty(PropertyName name) const {
+  if (name == kPropText)
+    return text_;
+  return NativeHeadless::GetProperty(name);
+}
+
+bool Headless::Slider::SetProperty(PropertyName name, const Value &value) {
+  if (name == kPropMin) {
+    min_ = value.Coerce<int32_t>();
+    return true;
+  }
+  if (name == kPropMax) {
+    max_ = value.Coerce<int32_t>();
+    return true;
+  }
+  if (name == kPropTicks) {
+    ticks_ = value.Coerce<uint32_t>();
+    return true;
+  }
+  return Control::SetProperty(name, value);
+}
+
+Value Headless::Slider::GetProperty(PropertyName name) const {
+  if (name == kPropMin)
+    return min_;
+  if (name == kPropMax)
+    return max_;
+  if (name == kPropTicks)
+    return ticks_;
+  return Control::GetProperty(name);
+}
+
+// Tick marks go below the slider.
+Size Headless::Slider::GetMinimumSize() const {
+  return Size(20, (ticks_ == 0) ? 21 : 25);
+}
+
+void Headless::Separator::Finalize() {
+  Layout *layout = entity_->GetLayout();
+
+  if (layout == NULL)
+    return;
+  if (layout->GetDirection() == Layout::kLayoutRow)
+    layout->SetVSizeOption(kSizeFill);
+  else  // kLayoutColumn
+    layout->SetHSizeOption(kSizeFill);
+}
+
+Value Headless::Separator::GetProperty(PropertyName name) const {
+  if (name == kPropMinimumSize)
+    return Size(2, 2);
+  if (name == kPropPadding) {
+    const Layout *layout = entity_->GetLayout();
+
+    if (layout == NULL)
+      return Value();
+    if (layout->GetDirection() == Layout::kLayoutRow)
+      return Spacing(2, 10, 2, 10);
+    else  // kLayoutColumn
+      return Spacing(10, 2, 10, 2);
+  }
+  return NativeHeadless::GetProperty(name);
+}
+
+}  // namespace Diadem
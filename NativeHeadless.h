@@ -0,0 +1,403 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_NATIVEHEADLESS_H_
+#define DIADEM_NATIVEHEADLESS_H_
+
+#include "Diadem/Native.h"
+#include "Diadem/Window.h"
+
+namespace Diadem {
+
+class Factory;
+
+// Native classes that have no user interface, for laying out windows where
+// there is no window system, such as on a server. Text is measured by a
+// TextMeasurer, and geometry and other state are kept in the objects.
+//
+// Each headless object uses the metrics and measurer that were current when
+// it was created. By default those are shared by all threads, and they must
+// be set before any windows are loaded. A ThreadSettings object can replace
+// them on one thread, so that windows for different locales can be loaded
+// and laid out on several threads at once. Each window must still be used by
+// only one thread at a time.
+class Headless {
+ public:
+  static void SetUpFactory(Factory *factory);
+
+  // The fonts that controls draw their text in.
+  enum Font {
+    kFontRegular,
+    kFontSmall,
+    kFontMini,
+    kFontHeading,
+    kFontCount  // The number of fonts
+  };
+
+  // Measures text for the minimum sizes of controls. MeasureText may be
+  // called on several threads at once.
+  class TextMeasurer {
+   public:
+    virtual ~TextMeasurer() {}
+
+    // Returns the size of the text. If wrap_width is greater than 0, lines
+    // are broken between words to keep them within that width where
+    // possible.
+    virtual Size MeasureText(
+        const char *text, Font font, int32_t wrap_width) const = 0;
+    // The distance from the top of a line of text to its baseline.
+    virtual int32_t GetBaseline(Font font) const = 0;
+  };
+
+  // Measures every character as the same width. This is the default
+  // measurer.
+  class FixedWidthMeasurer : public TextMeasurer {
+   public:
+    struct FontMetrics {
+      int32_t char_width, line_height, baseline;
+    };
+
+    FixedWidthMeasurer();
+
+    void SetFontMetrics(Font font, const FontMetrics &metrics);
+
+    virtual Size MeasureText(
+        const char *text, Font font, int32_t wrap_width) const;
+    virtual int32_t GetBaseline(Font font) const
+      { return fonts_[font].baseline; }
+
+   protected:
+    FontMetrics fonts_[kFontCount];
+  };
+
+  static void SetPlatformMetrics(const PlatformMetrics &metrics)
+    { metrics_ = metrics; }
+  // The measurer is not owned, and must last as long as it is in use. NULL
+  // restores the default FixedWidthMeasurer.
+  static void SetTextMeasurer(const TextMeasurer *measurer);
+  static const TextMeasurer& GetTextMeasurer() { return *measurer_; }
+
+  // Replaces the metrics and measurer for objects created on the calling
+  // thread while this exists. NULL keeps the current one. Neither is copied,
+  // so both must last as long as the objects. Settings can be nested, and
+  // must be destroyed in the reverse order.
+  class ThreadSettings {
+   public:
+    ThreadSettings(
+        const PlatformMetrics *metrics, const TextMeasurer *measurer);
+    ~ThreadSettings();
+
+    // The settings for the calling thread, or NULL if there are none.
+    static const ThreadSettings* Current();
+
+    const PlatformMetrics& GetPlatformMetrics() const { return *metrics_; }
+    const TextMeasurer& GetTextMeasurer() const { return *measurer_; }
+
+   protected:
+    const ThreadSettings *previous_;
+    const PlatformMetrics *metrics_;
+    const TextMeasurer *measurer_;
+
+   private:  // Disallow copying
+    ThreadSettings(const ThreadSettings&);
+    void operator=(const ThreadSettings&);
+  };
+
+  // The values for objects created on the calling thread.
+  static const PlatformMetrics& CurrentPlatformMetrics();
+  static const TextMeasurer& CurrentTextMeasurer();
+
+  // Abstract superclass for all headless native classes
+  class NativeHeadless : public Native {
+   public:
+    NativeHeadless()
+        : platform_metrics_(&CurrentPlatformMetrics()),
+          text_measurer_(&CurrentTextMeasurer()),
+          visible_(true), enabled_(true) {}
+
+    virtual bool SetProperty(PropertyName name, const Value &value);
+    virtual Value GetProperty(PropertyName name) const;
+
+    virtual const PlatformMetrics& GetPlatformMetrics() const
+      { return *platform_metrics_; }
+
+   protected:
+    const PlatformMetrics *platform_metrics_;
+    const TextMeasurer *text_measurer_;
+    // The location is relative to the window, as a view's frame would be.
+    Location location_;
+    Size size_;
+    bool visible_, enabled_;
+  };
+
+  // <window> implementation
+  class Window : public NativeHeadless, public WindowInterface {
+   public:
+    Window() : style_(0), focus_(NULL) { visible_ = false; }
+
+    WindowInterface* GetWindowInterface() { return this; }
+
+    virtual TypeName GetTypeName() const { return kTypeNameWindow; }
+    // The window's location is on the screen, and views inside it are
+    // located relative to the window.
+    virtual bool IsSuperview() const { return true; }
+
+    virtual bool SetProperty(PropertyName name, const Value &value);
+    virtual Value GetProperty(PropertyName name) const;
+
+    // WindowInterface
+    virtual bool ShowModeless();
+    virtual bool Close();
+    // There is no event loop, so modal windows are not supported.
+    virtual bool ShowModal(void *parent) { return false; }
+    virtual bool EndModal() { return false; }
+    virtual bool SetFocus(Entity *new_focus);
+    virtual bool TestClose();
+
+    Entity* GetFocus() { return focus_; }
+
+    typedef Diadem::RootEntity EntityType;
+    typedef BorderedContainer LayoutType;
+
+   protected:
+    String title_;
+    uint32_t style_;  // WindowStyleBits
+    Entity *focus_;
+  };
+
+  // <box> implementation
+  class Box : public NativeHeadless {
+   public:
+    Box() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameBox; }
+    virtual Value GetProperty(PropertyName name) const;
+
+    typedef Entity EntityType;
+    typedef BorderedContainer LayoutType;
+  };
+
+  // Base class for controls that are sized to fit their text. The minimum
+  // size is the text size plus the control's frame.
+  class Control : public NativeHeadless {
+   public:
+    Control() : font_(kFontRegular), value_(0) {}
+
+    virtual bool SetProperty(PropertyName name, const Value &value);
+    virtual Value GetProperty(PropertyName name) const;
+
+    typedef Entity EntityType;
+    typedef Layout LayoutType;
+
+   protected:
+    String text_;
+    Font font_;
+    int32_t value_;
+
+    // The space between the text and the edges of the control
+    virtual Spacing GetFrame() const { return Spacing(); }
+    virtual Spacing GetPadding() const { return Spacing(8, 8, 8, 8); }
+    virtual Size GetMinimumSize() const;
+
+    // Returns the value for the control's UI size.
+    int32_t ForUISize(int32_t regular, int32_t small, int32_t mini) const;
+    // Sets the value, and sends a change notification if it is different.
+    void ChangeValue(int32_t value);
+  };
+
+  // <button> implementation
+  class PushButton : public Control {
+   public:
+    PushButton() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameButton; }
+    virtual bool SetProperty(PropertyName name, const Value &value);
+
+   protected:
+    virtual Spacing GetFrame() const;
+    virtual Spacing GetPadding() const;
+  };
+
+  // <check> implementation
+  class Checkbox : public Control {
+   public:
+    Checkbox() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameCheck; }
+    virtual bool SetProperty(PropertyName name, const Value &value);
+
+   protected:
+    virtual Spacing GetFrame() const;
+    virtual Spacing GetPadding() const;
+  };
+
+  // <radio> implementation
+  class Radio : public Checkbox {
+   public:
+    Radio() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameRadio; }
+  };
+
+  // <label> implementation. A label that fills its width wraps its text
+  // to fit.
+  class Label : public Control {
+   public:
+    Label() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameLabel; }
+    virtual bool SetProperty(PropertyName name, const Value &value);
+
+   protected:
+    virtual Size GetMinimumSize() const;
+  };
+
+  // <link> implementation
+  class Link : public Label {
+   public:
+    Link() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameLink; }
+    virtual bool SetProperty(PropertyName name, const Value &value);
+    virtual Value GetProperty(PropertyName name) const;
+
+   protected:
+    String url_;
+  };
+
+  // <edit> implementation
+  class EditField : public Control {
+   public:
+    EditField() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameEdit; }
+
+   protected:
+    virtual Spacing GetFrame() const { return Spacing(3, 3, 2, 3); }
+    virtual Spacing GetPadding() const { return Spacing(10, 8, 10, 8); }
+  };
+
+  // <password> implementation
+  class PasswordField : public EditField {
+   public:
+    PasswordField() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNamePassword; }
+  };
+
+  // <path> implementation
+  class PathBox : public EditField {
+   public:
+    PathBox() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNamePath; }
+
+   protected:
+    // The path is shortened to fit, so it doesn't affect the size.
+    virtual Size GetMinimumSize() const { return Size(20, 20); }
+  };
+
+  // <popup> implementation. The popup is wide enough for its longest item.
+  class Popup : public Control {
+   public:
+    Popup() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNamePopup; }
+    virtual void AddChild(Native *child);
+    virtual bool SetProperty(PropertyName name, const Value &value);
+
+   protected:
+    Array<Native*> items_;
+
+    virtual Spacing GetFrame() const { return Spacing(2, 10, 3, 26); }
+    virtual Spacing GetPadding() const;
+    virtual Size GetMinimumSize() const;
+  };
+
+  // <item> implementation
+  class PopupItem : public NativeHeadless {
+   public:
+    PopupItem() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameItem; }
+    virtual bool SetProperty(PropertyName name, const Value &value);
+    virtual Value GetProperty(PropertyName name) const;
+
+    typedef Entity EntityType;
+
+   protected:
+    String text_;
+  };
+
+  // <slider> implementation
+  class Slider : public Control {
+   public:
+    Slider() : min_(0), max_(100), ticks_(0) {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameSlider; }
+    virtual bool SetProperty(PropertyName name, const Value &value);
+    virtual Value GetProperty(PropertyName name) const;
+
+   protected:
+    int32_t min_, max_;
+    uint32_t ticks_;
+
+    virtual Size GetMinimumSize() const;
+  };
+
+  // <separator> implementation
+  class Separator : public NativeHeadless {
+   public:
+    Separator() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameSeparator; }
+    virtual void Finalize();
+    virtual Value GetProperty(PropertyName name) const;
+
+    typedef Entity EntityType;
+    typedef Layout LayoutType;
+  };
+
+  // <image> implementation. Images are not loaded, so they have a fixed
+  // size.
+  class Image : public Control {
+   public:
+    Image() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameImage; }
+
+   protected:
+    virtual Size GetMinimumSize() const { return Size(20, 20); }
+  };
+
+  // <appicon> implementation
+  class AppIcon : public Control {
+   public:
+    AppIcon() {}
+
+    virtual TypeName GetTypeName() const { return kTypeNameAppIcon; }
+
+   protected:
+    virtual Spacing GetPadding() const { return Spacing(12, 19, 12, 19); }
+    virtual Size GetMinimumSize() const { return Size(64, 64); }
+  };
+
+ protected:
+  static PlatformMetrics metrics_;
+  static const TextMeasurer *measurer_;
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_NATIVEHEADLESS_H_
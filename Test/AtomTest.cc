@@ -0,0 +1,55 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+
+#include "Diadem/Atom.h"
+#include "Diadem/Layout.h"
+
+TEST(AtomTest, Intern) {
+  char buffer[] = "atomtest";
+  const Diadem::Atom a("atomtest"), b(buffer);
+
+  EXPECT_TRUE(a == b);
+  EXPECT_EQ(a.Get(), b.Get());
+  EXPECT_EQ(a.Index(), b.Index());
+  EXPECT_EQ(8u, a.Length());
+  EXPECT_STREQ("atomtest", a);
+  EXPECT_TRUE(a != Diadem::Atom("atomtest2"));
+}
+
+TEST(AtomTest, Empty) {
+  const Diadem::Atom a, b(""), c(static_cast<const char*>(NULL));
+
+  EXPECT_TRUE(a.IsEmpty());
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a == c);
+  EXPECT_EQ(0u, a.Index());
+  EXPECT_STREQ("", a.Get());
+}
+
+TEST(AtomTest, Constants) {
+  EXPECT_TRUE(Diadem::kPropVisible == Diadem::PropertyName("visible"));
+  EXPECT_TRUE(Diadem::kPropVisible == "visible");
+  EXPECT_NE(Diadem::kPropVisible.Index(), Diadem::kPropSize.Index());
+}
+
+TEST(AtomTest, Table) {
+  Diadem::AtomTable<int> table;
+
+  table.Insert(Diadem::kPropSize, 5);
+  EXPECT_EQ(5, table.Find(Diadem::kPropSize));
+  EXPECT_EQ(0, table.Find(Diadem::kPropLocation));
+  EXPECT_EQ(0, table.Find(Diadem::Atom("notintable")));
+}
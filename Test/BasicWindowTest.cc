@@ -142,6 +142,14 @@ TEST_F(BasicWindowTest, Paths) {
   EXPECT_STREQ("/window/group2", group2->GetPath());
   EXPECT_STREQ("/window/group2/label1", labelC->GetPath());
   EXPECT_STREQ("/window/label2", labelD->GetPath());
+
+  // Later siblings are renumbered when one is removed
+  windowRoot_->RemoveChild(labelA);
+  EXPECT_EQ(0, windowRoot_->ChildIndexByType(labelA));
+  EXPECT_EQ(1, windowRoot_->ChildIndexByType(labelD));
+  EXPECT_EQ(2, windowRoot_->ChildIndexByType(group2));
+  EXPECT_STREQ("/window/label1", labelD->GetPath());
+  delete labelA;
 }
 
 // Tests parsing the window "style" attribute
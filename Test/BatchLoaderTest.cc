@@ -0,0 +1,168 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "Diadem/BatchLoader.h"
+#include "Diadem/LibXMLCompiler.h"
+
+using Diadem::BatchLoader;
+using Diadem::Headless;
+
+namespace {
+
+// The check's value is broadcast when the window is finalized, and the
+// binding copies it into the empty label. That goes through the window's
+// ChangeMessenger, so each job exercises its own messenger. The label is
+// the last entity with a layout, so its frame is the last one.
+const char kBatchWindow[] =
+    "<window text='Batch' direction='column'>"
+      "<labelgroup text='Name:'><edit widthName='w'/></labelgroup>"
+      "<labelgroup text='A longer label:'><edit widthName='w'/></labelgroup>"
+      "<multi><group><check text='One'/><radio text='Two'/></group>"
+        "<group><popup><item text='Item'/></popup></group></multi>"
+      "<label text='Some text that wraps when it is narrow' width='fill'/>"
+      "<box><group><button text='Cancel'/><button text='OK'/></group></box>"
+      "<edit width='10em'/>"
+      "<check name='flag' text='Flag' value='1'/>"
+      "<label name='echo' text=''><bind source='flag' prop='text'/></label>"
+    "</window>";
+
+// Returns true if the binding gave the empty label some text.
+bool EchoedValue(const BatchLoader::Result &result) {
+  return !result.frames.empty() && (result.frames.back().width > 0);
+}
+
+bool SameFrames(const BatchLoader::Result &a, const BatchLoader::Result &b) {
+  if ((a.loaded != b.loaded) || (a.frames.size() != b.frames.size()))
+    return false;
+  for (size_t i = 0; i < a.frames.size(); ++i) {
+    const BatchLoader::Frame &fa = a.frames[i], &fb = b.frames[i];
+
+    if ((fa.parent != fb.parent) || (fa.x != fb.x) || (fa.y != fb.y) ||
+        (fa.width != fb.width) || (fa.height != fb.height))
+      return false;
+  }
+  return true;
+}
+
+class BatchLoaderTest : public testing::Test {
+ public:
+  BatchLoaderTest() {
+    strcpy(path_, "/tmp/BatchLoaderTestXXXXXX");
+    close(mkstemp(path_));
+  }
+  ~BatchLoaderTest() { unlink(path_); }
+
+  void WriteCompiledFile(const char *data) {
+    Diadem::Array<char> compiled;
+
+    ASSERT_TRUE(Diadem::LibXMLCompiler().CompileData(data, &compiled));
+
+    FILE* const file = fopen(path_, "wb");
+
+    ASSERT_TRUE(file != NULL);
+    fwrite(&compiled[0], 1, compiled.size(), file);
+    fclose(file);
+  }
+
+  char path_[32];
+};
+
+}  // namespace
+
+// Frames are listed parent first, with locations relative to the parent.
+TEST_F(BatchLoaderTest, Frames) {
+  BatchLoader loader(0);
+  Diadem::Array<BatchLoader::Job> jobs;
+  Diadem::Array<BatchLoader::Result> results;
+  const BatchLoader::Job window_job =
+      { NULL, "<window><button text='OK'/></window>", NULL, NULL };
+  const BatchLoader::Job bad_job = { NULL, "<window>", NULL, NULL };
+
+  jobs.push_back(window_job);
+  jobs.push_back(bad_job);
+  loader.Run(jobs, &results);
+  ASSERT_EQ(2u, results.size());
+  EXPECT_FALSE(results[1].loaded);
+  ASSERT_TRUE(results[0].loaded);
+  ASSERT_EQ(2u, results[0].frames.size());
+
+  const BatchLoader::Frame &window = results[0].frames[0];
+  const BatchLoader::Frame &button = results[0].frames[1];
+
+  EXPECT_EQ(BatchLoader::kNoParent, window.parent);
+  EXPECT_EQ(0u, button.parent);
+  EXPECT_LT(0, button.width);
+  EXPECT_LE(button.x + button.width, window.width);
+  EXPECT_LE(button.y + button.height, window.height);
+}
+
+// Many windows with different metrics and measurers can be loaded at once,
+// with the same results as loading each one by itself.
+TEST_F(BatchLoaderTest, Stress) {
+  WriteCompiledFile(kBatchWindow);
+
+  Headless::FixedWidthMeasurer wide_measurer;
+  const Headless::FixedWidthMeasurer::FontMetrics wide_font = { 14, 17, 13 };
+  Diadem::PlatformMetrics large_metrics = {
+      20, 24, 24, Diadem::Spacing(16, 8, 16, 8) };
+
+  wide_measurer.SetFontMetrics(Headless::kFontRegular, wide_font);
+
+  // The XML and compiled versions of each variant should come out the same.
+  const BatchLoader::Job variants[] = {
+      { NULL, kBatchWindow, NULL, NULL },
+      { NULL, kBatchWindow, NULL, &wide_measurer },
+      { NULL, kBatchWindow, &large_metrics, NULL },
+      { NULL, kBatchWindow, &large_metrics, &wide_measurer },
+      { path_, NULL, NULL, NULL },
+      { path_, NULL, NULL, &wide_measurer },
+      { path_, NULL, &large_metrics, NULL },
+      { path_, NULL, &large_metrics, &wide_measurer },
+  };
+  const size_t kVariantCount = sizeof(variants) / sizeof(variants[0]);
+  BatchLoader loader(8);
+  Diadem::Array<BatchLoader::Result> expected;
+
+  for (size_t i = 0; i < kVariantCount; ++i) {
+    Diadem::Array<BatchLoader::Job> jobs;
+    Diadem::Array<BatchLoader::Result> results;
+
+    jobs.push_back(variants[i]);
+    loader.Run(jobs, &results);
+    ASSERT_TRUE(results[0].loaded);
+    EXPECT_TRUE(EchoedValue(results[0])) << "variant " << i;
+    expected.push_back(results[0]);
+  }
+  EXPECT_TRUE(SameFrames(expected[0], expected[4]));
+  EXPECT_TRUE(SameFrames(expected[3], expected[7]));
+  EXPECT_LT(expected[0].frames[0].width, expected[1].frames[0].width);
+  EXPECT_FALSE(SameFrames(expected[0], expected[2]));
+
+  Diadem::Array<BatchLoader::Job> jobs;
+  Diadem::Array<BatchLoader::Result> results;
+
+  for (size_t i = 0; i < 512; ++i)
+    jobs.push_back(variants[(i * 5) % kVariantCount]);
+  loader.Run(jobs, &results);
+  ASSERT_EQ(jobs.size(), results.size());
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    EXPECT_TRUE(SameFrames(expected[(i * 5) % kVariantCount], results[i]))
+        << "job " << i;
+    EXPECT_TRUE(EchoedValue(results[i])) << "job " << i;
+  }
+}
@@ -56,6 +56,148 @@ TEST_F(TestBindings, testRemoveObserver) {
   EXPECT_EQ(2, ob2.observe_count_);
 }
 
+TEST_F(TestBindings, testObserverIndex) {
+  class Ob : public Diadem::ValueObserver {
+   public:
+    Ob() : observe_count_(0) {}
+
+    void ObserveImp(const char*, const Diadem::Value&)
+      { ++observe_count_; }
+
+    unsigned int observe_count_;
+  };
+
+  Diadem::ChangeMessenger messenger;
+  Ob ob1, ob2, ob3;
+  Diadem::Value v;
+
+  messenger.AddObserver("a", &ob1);
+  messenger.AddObserver("a", &ob1);  // Duplicates are ignored
+  messenger.AddObserver("b", &ob1);
+  messenger.AddObserver("a", &ob2);
+  messenger.AddObserver("c", &ob3);
+  messenger.NotifyChange("a", v);
+  EXPECT_EQ(1, ob1.observe_count_);
+  EXPECT_EQ(1, ob2.observe_count_);
+  EXPECT_EQ(0, ob3.observe_count_);
+  messenger.NotifyChange("b", v);
+  messenger.NotifyChange("d", v);
+  EXPECT_EQ(2, ob1.observe_count_);
+  EXPECT_EQ(1, ob2.observe_count_);
+  EXPECT_EQ(0, ob3.observe_count_);
+  messenger.RemoveObserver(&ob1);
+  messenger.NotifyChange("a", v);
+  messenger.NotifyChange("b", v);
+  messenger.NotifyChange("c", v);
+  EXPECT_EQ(2, ob1.observe_count_);
+  EXPECT_EQ(2, ob2.observe_count_);
+  EXPECT_EQ(1, ob3.observe_count_);
+  messenger.RemoveObserver(&ob2);
+  messenger.RemoveObserver(&ob3);
+  messenger.NotifyChange("a", v);
+  messenger.NotifyChange("c", v);
+  EXPECT_EQ(2, ob2.observe_count_);
+  EXPECT_EQ(1, ob3.observe_count_);
+}
+
+// Observers can add and remove observers while a change is delivered.
+TEST_F(TestBindings, testObserverChangesObservers) {
+  class Counter : public Diadem::ValueObserver {
+   public:
+    Counter() : observe_count_(0) {}
+
+    void ObserveImp(const char*, const Diadem::Value&)
+      { ++observe_count_; }
+
+    unsigned int observe_count_;
+  };
+  class Adder : public Diadem::ValueObserver {
+   public:
+    Adder(Diadem::ChangeMessenger *messenger, Counter *counters,
+          Counter *removed)
+        : messenger_(messenger), counters_(counters), removed_(removed) {}
+
+    // Adds enough observers to grow both the name map and the list for
+    // "a", then removes one that hasn't been notified yet.
+    void ObserveImp(const char*, const Diadem::Value&) {
+      char name[16];
+
+      for (int i = 0; i < kCount; ++i) {
+        snprintf(name, sizeof(name), "name%d", i);
+        messenger_->AddObserver(name, &counters_[i]);
+        messenger_->AddObserver("a", &counters_[i]);
+      }
+      messenger_->RemoveObserver(removed_);
+    }
+
+    enum { kCount = 64 };
+
+    Diadem::ChangeMessenger *messenger_;
+    Counter *counters_, *removed_;
+  };
+
+  Diadem::ChangeMessenger messenger;
+  Counter counters[Adder::kCount], removed;
+  Adder adder(&messenger, counters, &removed);
+  Diadem::Value v;
+
+  messenger.AddObserver("a", &adder);
+  messenger.AddObserver("a", &removed);
+  messenger.NotifyChange("a", v);
+  EXPECT_EQ(0, removed.observe_count_);
+  EXPECT_EQ(0, counters[0].observe_count_);
+  messenger.RemoveObserver(&adder);
+  messenger.NotifyChange("a", v);
+  for (int i = 0; i < Adder::kCount; ++i)
+    EXPECT_EQ(1, counters[i].observe_count_);
+  EXPECT_EQ(0, removed.observe_count_);
+}
+
+TEST_F(TestBindings, testTransaction) {
+  class Ob : public Diadem::ValueObserver {
+   public:
+    Ob() : observe_count_(0) {}
+
+    void ObserveImp(const char*, const Diadem::Value &v) {
+      ++observe_count_;
+      last_value_ = v.Coerce<int32_t>();
+    }
+
+    unsigned int observe_count_;
+    int32_t last_value_;
+  };
+
+  Diadem::ChangeMessenger messenger;
+  Ob ob_a, ob_b, ob_all;
+
+  messenger.AddObserver("a", &ob_a);
+  messenger.AddObserver("b", &ob_b);
+  messenger.AddObserver("", &ob_all);
+  {
+    Diadem::ChangeTransaction transaction(&messenger);
+
+    messenger.NotifyChange("a", 1);
+    messenger.NotifyChange("a", 2);
+    messenger.BeginChanges();  // Nested transaction
+    messenger.NotifyChange("b", 3);
+    messenger.NotifyChange("a", 4);
+    messenger.CommitChanges();
+    EXPECT_TRUE(messenger.InTransaction());
+    EXPECT_EQ(0, ob_a.observe_count_);
+    EXPECT_EQ(0, ob_b.observe_count_);
+    EXPECT_EQ(0, ob_all.observe_count_);
+  }
+  EXPECT_FALSE(messenger.InTransaction());
+  EXPECT_EQ(1, ob_a.observe_count_);
+  EXPECT_EQ(4, ob_a.last_value_);
+  EXPECT_EQ(1, ob_b.observe_count_);
+  EXPECT_EQ(3, ob_b.last_value_);
+  EXPECT_EQ(2, ob_all.observe_count_);  // Once for each changed value
+  EXPECT_EQ(3, ob_all.last_value_);
+  messenger.NotifyChange("a", 5);
+  EXPECT_EQ(2, ob_a.observe_count_);
+}
+
 TEST_F(TestBindings, testValueToEnable) {
   ReadWindowData(
       "<window text='testValueToEnable'>"
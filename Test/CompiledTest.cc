@@ -0,0 +1,213 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "XMLTest.h"
+#include "Diadem/CompiledFormat.h"
+#include "Diadem/CompiledParser.h"
+#include "Diadem/Factory.h"
+#include "Diadem/Layout.h"
+#include "Diadem/LibXMLCompiler.h"
+#include "Diadem/LibXMLParser.h"
+#include "Diadem/NativeHeadless.h"
+
+namespace {
+
+// Compiles the XML and loads the result, so the XML tests can check that
+// compiled resources load the same way.
+class CompilingParser : public Diadem::Parser {
+ public:
+  explicit CompilingParser(const Diadem::Factory &factory)
+      : parser_(factory) {}
+
+  Diadem::Entity* LoadEntityFromData(const char *data) const {
+    Diadem::Array<char> compiled;
+
+    if (!Diadem::LibXMLCompiler().CompileData(data, &compiled))
+      return NULL;
+    return parser_.LoadEntityFromData(&compiled[0], compiled.size());
+  }
+
+ protected:
+  Diadem::CompiledParser parser_;
+};
+
+class CompiledTest : public XMLTest {
+ public:
+  Diadem::Parser* MakeParser(const Diadem::Factory &factory)
+    { return new CompilingParser(factory); }
+};
+
+XML_TESTS(CompiledTest)
+
+const char kSizesWindow[] =
+    "<window text='Sizes' direction='column'>"
+      "<edit width='12em' name='em'/>"
+      "<edit width='indent' name='indent'/>"
+      "<edit width='50' height='3li' name='lines'/>"
+      "<label text='Wrapped label text' width='fill' name='fill'/>"
+      "<labelgroup text='Label:' width='20em' name='group'>"
+        "<edit width='fit'/>"
+      "</labelgroup>"
+    "</window>";
+
+void ExpectSameLayout(Diadem::Entity *expected, Diadem::Entity *actual) {
+  Diadem::Layout* const expected_layout = expected->GetLayout();
+  Diadem::Layout* const actual_layout = actual->GetLayout();
+
+  ASSERT_EQ(expected_layout == NULL, actual_layout == NULL);
+  if (expected_layout != NULL) {
+    const Diadem::ExplicitSize &a = expected_layout->GetExplicitSize();
+    const Diadem::ExplicitSize &b = actual_layout->GetExplicitSize();
+
+    EXPECT_EQ(expected_layout->GetHSizeOption(),
+              actual_layout->GetHSizeOption());
+    EXPECT_EQ(expected_layout->GetVSizeOption(),
+              actual_layout->GetVSizeOption());
+    EXPECT_EQ(a.width_, b.width_);
+    EXPECT_EQ(a.width_units_, b.width_units_);
+    EXPECT_EQ(a.height_, b.height_);
+    EXPECT_EQ(a.height_units_, b.height_units_);
+    EXPECT_EQ(expected_layout->GetSize(), actual_layout->GetSize());
+    EXPECT_EQ(expected_layout->GetLocation(), actual_layout->GetLocation());
+  }
+  ASSERT_EQ(expected->ChildrenCount(), actual->ChildrenCount());
+  for (size_t i = 0; i < expected->ChildrenCount(); ++i)
+    ExpectSameLayout(expected->ChildAt(i), actual->ChildAt(i));
+}
+
+}  // namespace
+
+// Widths and heights are parsed by the compiler, with the same results as
+// when they are parsed from XML.
+TEST(CompiledParserTest, Sizes) {
+  Diadem::Factory factory;
+
+  Diadem::Headless::SetUpFactory(&factory);
+
+  Diadem::Entity* const expected =
+      Diadem::LibXMLParser(factory).LoadEntityFromData(kSizesWindow);
+  Diadem::Entity* const actual =
+      CompilingParser(factory).LoadEntityFromData(kSizesWindow);
+
+  ASSERT_TRUE(expected != NULL);
+  ASSERT_TRUE(actual != NULL);
+  expected->GetLayout()->ResizeToMinimum();
+  actual->GetLayout()->ResizeToMinimum();
+  ExpectSameLayout(expected, actual);
+  EXPECT_EQ(Diadem::kSizeExplicit,
+            actual->FindByName("em")->GetLayout()->GetHSizeOption());
+  EXPECT_EQ(Diadem::kSizeFill,
+            actual->FindByName("fill")->GetLayout()->GetHSizeOption());
+  delete expected;
+  delete actual;
+}
+
+// Strings loaded from a file stay valid after the parser and the file are
+// gone.
+TEST(CompiledParserTest, File) {
+  char path[] = "/tmp/CompiledTestXXXXXX";
+  const int fd = mkstemp(path);
+  Diadem::Array<char> compiled;
+
+  ASSERT_NE(-1, fd);
+  ASSERT_TRUE(Diadem::LibXMLCompiler().CompileData(
+      "<entity name='outside' text='Outside text'>"
+        "<entity name='inside' text='Inside text'/>"
+      "</entity>",
+      &compiled));
+  ASSERT_EQ((ssize_t)compiled.size(),
+            write(fd, &compiled[0], compiled.size()));
+  close(fd);
+
+  Diadem::Factory factory;
+  Diadem::Entity *result;
+
+  factory.Register<Diadem::Entity>("entity");
+  {
+    Diadem::CompiledParser parser(factory);
+
+    result = parser.LoadEntityFromFile(path);
+    EXPECT_EQ((Diadem::Entity*)NULL,
+              parser.LoadEntityFromFile("/nonexistent/file.demb"));
+  }
+  unlink(path);
+  ASSERT_NE((Diadem::Entity*)NULL, result);
+  EXPECT_STREQ("outside", result->GetName());
+  ASSERT_EQ(1, result->ChildrenCount());
+  EXPECT_STREQ("inside", result->ChildAt(0)->GetName());
+  EXPECT_EQ(result->ChildAt(0), result->FindByName("inside"));
+  delete result;
+}
+
+// Damaged data, and data compiled for another platform, are not loaded.
+TEST(CompiledParserTest, Invalid) {
+  Diadem::Factory factory;
+  Diadem::CompiledParser parser(factory);
+  Diadem::Array<char> compiled;
+
+  factory.Register<Diadem::Entity>("entity");
+  ASSERT_TRUE(Diadem::LibXMLCompiler().CompileData(
+      "<entity name='outside'><entity name='inside'/></entity>", &compiled));
+
+  Diadem::Entity* const result =
+      parser.LoadEntityFromData(&compiled[0], compiled.size());
+
+  ASSERT_NE((Diadem::Entity*)NULL, result);
+  delete result;
+
+  Diadem::CompiledHeader header;
+
+  memcpy(&header, &compiled[0], sizeof(header));
+
+  // The root's end must cover the whole table.
+  Diadem::Array<char> damaged(compiled);
+  Diadem::CompiledEntity entity;
+
+  memcpy(&entity, &damaged[header.entities_offset], sizeof(entity));
+  entity.end = 1;
+  memcpy(&damaged[header.entities_offset], &entity, sizeof(entity));
+  EXPECT_EQ((Diadem::Entity*)NULL, parser.LoadEntityFromData(&damaged[0]));
+
+  // String offsets must be within the characters.
+  damaged = compiled;
+
+  Diadem::CompiledString string;
+
+  memcpy(&string, &damaged[header.strings_offset], sizeof(string));
+  string.offset = header.characters_size;
+  memcpy(&damaged[header.strings_offset], &string, sizeof(string));
+  EXPECT_EQ((Diadem::Entity*)NULL, parser.LoadEntityFromData(&damaged[0]));
+
+  damaged = compiled;
+  damaged[0] = 'X';
+  EXPECT_EQ((Diadem::Entity*)NULL, parser.LoadEntityFromData(&damaged[0]));
+
+  // Data shorter than its header says, or than the header itself, is
+  // rejected without being read past its end.
+  EXPECT_EQ((Diadem::Entity*)NULL,
+            parser.LoadEntityFromData(&compiled[0], compiled.size() - 1));
+  EXPECT_EQ((Diadem::Entity*)NULL,
+            parser.LoadEntityFromData(&compiled[0], sizeof(header) - 1));
+  EXPECT_EQ((Diadem::Entity*)NULL,
+            parser.LoadEntityFromData(&compiled[0], 0));
+
+  ASSERT_TRUE(Diadem::LibXMLCompiler("otheros").CompileData(
+      "<entity name='outside'/>", &compiled));
+  EXPECT_EQ((Diadem::Entity*)NULL, parser.LoadEntityFromData(&compiled[0]));
+}
@@ -16,6 +16,7 @@
 
 #include "Diadem/Entity.h"
 #include "Diadem/Factory.h"
+#include "Diadem/Native.h"
 #include "Diadem/Value.h"
 #include "Diadem/Wrappers.h"
 
@@ -82,3 +83,120 @@ TEST(EntityTest, ParentChild) {
   EXPECT_EQ(&child2, parent.ChildAt(0));
   parent.RemoveChild(&child2);
 }
+
+// Tests that the root's name index follows names and hierarchy changes
+TEST(EntityTest, NameIndex) {
+  Diadem::RootEntity root;
+  Diadem::Entity group, child1, child2;
+
+  root.SetName("root");
+  child1.SetName("bill");
+  group.AddChild(&child1);
+  root.AddChild(&group);
+  root.AddChild(&child2);
+  EXPECT_EQ(&child1, root.FindByName("bill"));
+  EXPECT_EQ(&child1, group.FindByName("bill"));
+  EXPECT_EQ(NULL, group.FindByName("root"));
+
+  child2.SetName("ted");
+  EXPECT_EQ(&child2, root.FindByName("ted"));
+  child2.SetName("rufus");
+  EXPECT_EQ(NULL, root.FindByName("ted"));
+  EXPECT_EQ(&child2, root.FindByName("rufus"));
+
+  root.RemoveChild(&group);
+  EXPECT_EQ(NULL, root.FindByName("bill"));
+  EXPECT_EQ(&child1, group.FindByName("bill"));
+  root.RemoveChild(&child2);
+  group.RemoveChild(&child1);
+}
+
+// Duplicate names are reported, and lookups return the first match
+TEST(EntityTest, DuplicateNames) {
+  Diadem::RootEntity root;
+  Diadem::Entity child1, child2;
+
+  child1.SetName("twin");
+  child2.SetName("twin");
+  root.AddChild(&child1);
+  root.AddChild(&child2);
+  ASSERT_EQ(1u, root.GetNameIndex()->DuplicateNames().size());
+  EXPECT_STREQ("twin", root.GetNameIndex()->DuplicateNames()[0]);
+  EXPECT_EQ(&child1, root.FindByName("twin"));
+
+  child1.SetName("single");
+  EXPECT_TRUE(root.GetNameIndex()->DuplicateNames().empty());
+  EXPECT_EQ(&child2, root.FindByName("twin"));
+  EXPECT_EQ(&child1, root.FindByName("single"));
+  root.RemoveChild(&child1);
+  root.RemoveChild(&child2);
+}
+
+// Property values are only fetched when a change has observers
+TEST(EntityTest, PropertyChangedObservers) {
+  class CountingEntity : public Diadem::Entity {
+   public:
+    CountingEntity() : get_count_(0) {}
+
+    Diadem::Value GetProperty(Diadem::PropertyName name) const {
+      ++get_count_;
+      return Diadem::Value(5);
+    }
+
+    mutable unsigned int get_count_;
+  };
+
+  class Ob : public Diadem::ValueObserver {
+   public:
+    Ob() : observe_count_(0) {}
+
+    void ObserveImp(const char*, const Diadem::Value&)
+      { ++observe_count_; }
+
+    unsigned int observe_count_;
+  };
+
+  Diadem::RootEntity root;
+  CountingEntity child;
+  Ob ob;
+
+  child.SetName("counter");
+  root.AddChild(&child);
+  child.PropertyChanged(Diadem::kPropValue);
+  EXPECT_EQ(0u, child.get_count_);
+  EXPECT_STREQ("counter.value", child.GetPropertyPath(Diadem::kPropValue));
+
+  root.GetChangeMessenger()->AddObserver("counter.value", &ob);
+  child.PropertyChanged(Diadem::kPropValue);
+  EXPECT_EQ(1u, child.get_count_);
+  EXPECT_EQ(1u, ob.observe_count_);
+  child.PropertyChanged(Diadem::kPropText);
+  EXPECT_EQ(1u, child.get_count_);
+
+  child.SetName("renamed");
+  EXPECT_STREQ("renamed.value", child.GetPropertyPath(Diadem::kPropValue));
+  child.PropertyChanged(Diadem::kPropValue);
+  EXPECT_EQ(1u, ob.observe_count_);
+  root.GetChangeMessenger()->RemoveObserver(&ob);
+  root.RemoveChild(&child);
+}
+
+// State found from the root follows the entity when it is moved
+TEST(EntityTest, AncestorState) {
+  Diadem::RootEntity root;
+  Diadem::Entity group, child;
+
+  group.AddChild(&child);
+  EXPECT_TRUE(child.GetChangeMessenger() == NULL);
+  EXPECT_TRUE(child.GetNameIndex() == NULL);
+
+  root.AddChild(&group);
+  EXPECT_EQ(root.GetChangeMessenger(), child.GetChangeMessenger());
+  EXPECT_EQ(root.GetNameIndex(), child.GetNameIndex());
+  EXPECT_EQ(root.GetSizeGroups(), child.GetSizeGroups());
+
+  root.RemoveChild(&group);
+  EXPECT_TRUE(child.GetChangeMessenger() == NULL);
+  EXPECT_TRUE(group.GetSizeGroups() == NULL);
+  group.RemoveChild(&child);
+}
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include "Diadem/Factory.h"
+#include "Diadem/Layout.h"
 #include "Diadem/Value.h"
 
 class FactoryTest : public testing::Test {
@@ -88,3 +89,49 @@ TEST(FactoryTest, BasicSession) {
   EXPECT_TRUE(parent->DidFinalize());
   EXPECT_TRUE(child->DidFinalize());
 }
+
+// A sealed factory creates the same entities, and ignores names that were
+// not registered.
+TEST(FactoryTest, Sealed) {
+  Diadem::Factory factory;
+  Diadem::PropertyMap properties;
+
+  factory.Register<TestEntity>(kEntityClassName);
+  factory.Seal();
+  EXPECT_TRUE(factory.IsSealed());
+  EXPECT_TRUE(factory.IsRegistered(kEntityClassName));
+  EXPECT_TRUE(factory.IsRegistered(Diadem::kTypeNameGroup));
+  EXPECT_FALSE(factory.IsRegistered("unregistered"));
+  properties.Insert(Diadem::kPropName, "Sealed");
+
+  Diadem::Entity* const entity =
+      factory.CreateEntity(kEntityClassName, properties);
+
+  ASSERT_TRUE(dynamic_cast<TestEntity*>(entity) != NULL);
+  EXPECT_STREQ("Sealed", entity->GetName());
+  delete entity;
+
+  Diadem::Entity* const group =
+      factory.CreateEntity(Diadem::kTypeNameGroup, properties);
+
+  ASSERT_NE((Diadem::Entity*)NULL, group);
+  EXPECT_NE((Diadem::Layout*)NULL, group->GetLayout());
+  delete group;
+  EXPECT_EQ((Diadem::Entity*)NULL,
+            factory.CreateEntity("unregistered", properties));
+}
+
+class TestPlatform {
+ public:
+  static void SetUpFactory(Diadem::Factory *factory)
+    { factory->Register<TestEntity>(kEntityClassName); }
+};
+
+// The shared factory is set up once.
+TEST(FactoryTest, Shared) {
+  const Diadem::Factory &factory = Diadem::Factory::Shared<TestPlatform>();
+
+  EXPECT_EQ(&factory, &Diadem::Factory::Shared<TestPlatform>());
+  EXPECT_TRUE(factory.IsSealed());
+  EXPECT_TRUE(factory.IsRegistered(kEntityClassName));
+}
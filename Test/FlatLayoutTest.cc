@@ -0,0 +1,98 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "Diadem/Test/WindowTestBase.h"
+#include "Diadem/FlatLayout.h"
+#include "Diadem/Layout.h"
+#include "Diadem/ThreadPool.h"
+
+// Checks FlatLayout in ways beyond the comparisons that LayoutTest and
+// GroupTest make on each of their windows.
+class FlatLayoutTest : public WindowTestBase {
+};
+
+// After a change, UpdateLayout lays out the window again at its current
+// size, as the layout objects would.
+TEST_F(FlatLayoutTest, testUpdateLayout) {
+  ReadWindowData(
+      "<window text='testUpdateLayout' direction='row'>"
+        "<group><label text='A' name='a'/></group>"
+        "<group><label text='B' name='b'/></group>"
+      "</window>");
+
+  Diadem::FlatLayout flat(windowRoot_->GetLayout());
+  Diadem::Layout* const label_aL = windowRoot_->FindByName("a")->GetLayout();
+  const Diadem::Size a_size = label_aL->GetSize();
+  std::vector<int32_t> expected, actual;
+
+  windowRoot_->FindByName("a")->SetText("A much longer label");
+  EXPECT_TRUE(windowObject_->NeedsLayout());
+  flat.UpdateLayout();
+  EXPECT_FALSE(windowObject_->NeedsLayout());
+  EXPECT_LT(a_size.width, label_aL->GetSize().width);
+  GetGeometry(windowRoot_, &actual);
+
+  InvalidateAll(windowRoot_);
+  windowObject_->UpdateLayout();
+  GetGeometry(windowRoot_, &expected);
+  EXPECT_EQ(expected, actual);
+}
+
+// A Multipanel big enough for its panels to be measured on the thread pool
+// gives the same geometry as without the pool, node by node.
+TEST_F(FlatLayoutTest, testParallelMultipanel) {
+  const int kPanelCount = 16, kControlsPerPanel = 80;
+  std::string data = "<window text='testParallelMultipanel'><multi>";
+
+  for (int panel = 0; panel < kPanelCount; ++panel) {
+    data += "<group direction='column'>";
+    for (int i = 0; i < kControlsPerPanel; ++i) {
+      char control[128];
+
+      // The text lengths vary so that each panel has a different width.
+      snprintf(control, sizeof(control),
+               (i % 2 == 0) ? "<label width='fill' text='%*d'/>"
+                            : "<button text='%*d'/>",
+               (panel * 7 + i) % 23 + 1, i);
+      data += control;
+    }
+    data += "</group>";
+  }
+  data += "</multi></window>";
+  ReadWindowData(data.c_str());
+
+  Diadem::ThreadPool pool(4);
+  Diadem::FlatLayout serial(windowRoot_->GetLayout());
+  Diadem::FlatLayout parallel(windowRoot_->GetLayout());
+  std::vector<int32_t> expected, actual;
+
+  parallel.SetThreadPool(&pool, 16);
+  InvalidateAll(windowRoot_);
+  serial.ResizeToMinimum();
+  GetGeometry(windowRoot_, &expected);
+  InvalidateAll(windowRoot_);
+  parallel.ResizeToMinimum();
+  GetGeometry(windowRoot_, &actual);
+  EXPECT_EQ(static_cast<size_t>(2 + kPanelCount * (1 + kControlsPerPanel)),
+            parallel.NodeCount());
+  EXPECT_EQ(expected, actual);
+
+  // Also at a larger size, and against the layout objects.
+  CompareFlatLayout(&parallel);
+}
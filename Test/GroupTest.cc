@@ -15,8 +15,12 @@
 #include "Diadem/Test/WindowTestBase.h"
 #include "Diadem/LabelGroup.h"
 
-// Layout tests involving nested containers.
+// Layout tests involving nested containers. Each window is also checked
+// against FlatLayout when the test finishes.
 class GroupTest : public WindowTestBase {
+ public:
+  GroupTest() { compareFlatLayout_ = true; }
+
  protected:
   void VerifyButtonGrid();
 };
@@ -716,3 +720,30 @@ TEST_F(GroupTest, testIconAndLabel) {
   EXPECT_EQ(0, icon_loc.x);
   EXPECT_EQ(0, icon_loc.y);
 }
+
+// Moving a group keeps its children's relative locations, and their views
+// move with it.
+TEST_F(GroupTest, testMoveGroup) {
+  ReadWindowData(
+      "<window text='testMoveGroup'>"
+        "<group name='g'>"
+          "<group>"
+            "<label text='Label' name='l'/>"
+          "</group>"
+        "</group>"
+      "</window>");
+
+  Diadem::Layout* const group_L = windowRoot_->FindByName("g")->GetLayout();
+  Diadem::Layout* const label_L = windowRoot_->FindByName("l")->GetLayout();
+  const Diadem::Location group_loc = group_L->GetLocation();
+  const Diadem::Location label_loc = label_L->GetLocation();
+  const Diadem::Location label_view_loc = label_L->GetViewLocation();
+  const Diadem::Location offset(10, 20);
+
+  group_L->SetLocation(group_loc + offset);
+  EXPECT_EQ(label_loc, label_L->GetLocation());
+  EXPECT_EQ(label_view_loc + offset, label_L->GetViewLocation());
+  EXPECT_EQ(label_loc,
+            windowRoot_->FindByName("l")->GetNativeProperty(
+                Diadem::kPropLocation).Coerce<Diadem::Location>());
+}
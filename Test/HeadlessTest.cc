@@ -0,0 +1,324 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+#include <libxml/parser.h>
+
+#include "Diadem/ChangeMessenger.h"
+#include "Diadem/Layout.h"
+#include "Diadem/LibXMLParser.h"
+#include "Diadem/NativeHeadless.h"
+#include "Diadem/ThreadPool.h"
+#include "Diadem/Window.h"
+
+using Diadem::Headless;
+
+// This doesn't use WindowTestBase because it tests the headless classes
+// specifically, even where another platform is the default.
+class HeadlessTest : public testing::Test {
+ public:
+  HeadlessTest() : window_object_(NULL) {}
+
+  testing::AssertionResult ReadWindowData(const char *data);
+
+  void TearDown() {
+    delete window_object_;
+    Headless::SetTextMeasurer(NULL);
+  }
+
+  Diadem::Size MinimumSizeOf(const char *name) {
+    return window_root_->FindByName(name)->GetNativeProperty(
+        Diadem::kPropMinimumSize).Coerce<Diadem::Size>();
+  }
+
+  Diadem::Window *window_object_;
+  Diadem::Entity *window_root_;
+};
+
+testing::AssertionResult HeadlessTest::ReadWindowData(const char *data) {
+  Diadem::Factory factory;
+
+  Headless::SetUpFactory(&factory);
+
+  Diadem::LibXMLParser parser(factory);
+
+  window_root_ = parser.LoadEntityFromData(data);
+  if (window_root_ == NULL)
+    return testing::AssertionFailure() << "load failed";
+  if (window_root_->GetNative() == NULL)
+    return testing::AssertionFailure() << "null native object";
+  if (window_root_->GetNative()->GetWindowInterface() == NULL)
+    return testing::AssertionFailure() << "null window interface";
+  window_object_ = new Diadem::Window(window_root_);
+  if (window_object_->ShowModeless())
+    window_root_->SetProperty(Diadem::kPropLocation, Diadem::Location(20, 50));
+  return testing::AssertionSuccess();
+}
+
+namespace {
+
+// Measures everything as twice as wide as the default measurer.
+class WideMeasurer : public Headless::TextMeasurer {
+ public:
+  virtual Diadem::Size MeasureText(
+      const char *text, Headless::Font font, int32_t wrap_width) const {
+    const Diadem::Size size = base_.MeasureText(text, font, wrap_width / 2);
+
+    return Diadem::Size(size.width * 2, size.height);
+  }
+  virtual int32_t GetBaseline(Headless::Font font) const
+    { return base_.GetBaseline(font); }
+
+ protected:
+  Headless::FixedWidthMeasurer base_;
+};
+
+}  // namespace
+
+TEST_F(HeadlessTest, FixedWidthMeasurer) {
+  Headless::FixedWidthMeasurer measurer;
+  const Headless::FixedWidthMeasurer::FontMetrics metrics = { 5, 10, 8 };
+
+  measurer.SetFontMetrics(Headless::kFontRegular, metrics);
+  EXPECT_EQ(Diadem::Size(0, 10),
+            measurer.MeasureText("", Headless::kFontRegular, 0));
+  EXPECT_EQ(Diadem::Size(55, 10),
+            measurer.MeasureText("Two words !", Headless::kFontRegular, 0));
+  EXPECT_EQ(Diadem::Size(25, 30),
+            measurer.MeasureText("Two words !", Headless::kFontRegular, 25));
+  EXPECT_EQ(Diadem::Size(45, 20),
+            measurer.MeasureText("Two words !", Headless::kFontRegular, 45));
+  // A word longer than the wrap width gets its own line.
+  EXPECT_EQ(Diadem::Size(50, 20),
+            measurer.MeasureText("A wordlonger", Headless::kFontRegular, 20));
+  EXPECT_EQ(Diadem::Size(15, 20),
+            measurer.MeasureText("One\nTw", Headless::kFontRegular, 0));
+  // Characters are counted, not bytes.
+  EXPECT_EQ(Diadem::Size(20, 10),
+            measurer.MeasureText("\xc3\xa9t\xc3\xa9s", Headless::kFontRegular,
+                                 0));
+}
+
+const char kMeasuredWindow[] =
+    "<window text='TextMeasurer'>"
+      "<button text='Button' name='b'/>"
+      "<label text='Label' name='l' uisize='small'/>"
+    "</window>";
+
+// Controls are sized to fit their text, measured by the current measurer.
+TEST_F(HeadlessTest, TextMeasurer) {
+  ASSERT_TRUE(ReadWindowData(kMeasuredWindow));
+
+  const Diadem::Size button_size = MinimumSizeOf("b");
+  const Diadem::Size label_size = MinimumSizeOf("l");
+  WideMeasurer measurer;
+
+  delete window_object_;
+  window_object_ = NULL;
+  Headless::SetTextMeasurer(&measurer);
+  ASSERT_TRUE(ReadWindowData(kMeasuredWindow));
+  EXPECT_EQ(button_size.height, MinimumSizeOf("b").height);
+  EXPECT_EQ(label_size.width * 2, MinimumSizeOf("l").width);
+  EXPECT_LT(button_size.width, MinimumSizeOf("b").width);
+  EXPECT_EQ(MinimumSizeOf("b"),
+            window_root_->FindByName("b")->GetLayout()->GetSize());
+}
+
+// A label that fills its width wraps to fit, and gets taller when it is
+// narrower.
+TEST_F(HeadlessTest, WrappingLabel) {
+  ASSERT_TRUE(ReadWindowData(
+      "<window text='WrappingLabel' direction='column'>"
+        "<label text='A label with enough words to wrap onto several lines' "
+            "width='fill' name='l'/>"
+        "<button text='Button'/>"
+      "</window>"));
+
+  Diadem::Layout* const label = window_root_->FindByName("l")->GetLayout();
+  Diadem::Layout* const root = window_root_->GetLayout();
+  const Diadem::Size narrow_size = label->GetSize();
+
+  root->SetSize(Diadem::Size(600, root->GetSize().height));
+  root->UpdateLayout();
+  EXPECT_LT(narrow_size.width, label->GetSize().width);
+  EXPECT_GT(narrow_size.height, label->GetSize().height);
+  EXPECT_EQ(Diadem::Size(label->GetSize().width, 17), label->GetSize());
+}
+
+// A popup is as wide as its longest item.
+TEST_F(HeadlessTest, Popup) {
+  ASSERT_TRUE(ReadWindowData(
+      "<window text='Popup'>"
+        "<popup name='p'>"
+          "<item text='Short'/>"
+          "<item text='Much longer item'/>"
+        "</popup>"
+        "<button text='Much longer item' name='b'/>"
+      "</window>"));
+
+  const Diadem::Spacing button_frame(2, 14, 2, 14), popup_frame(2, 10, 3, 26);
+
+  EXPECT_EQ((MinimumSizeOf("b") - button_frame).width,
+            (MinimumSizeOf("p") - popup_frame).width);
+}
+
+namespace {
+
+class CountingObserver : public Diadem::ValueObserver {
+ public:
+  CountingObserver() : count_(0) {}
+
+  int count_;
+
+ protected:
+  virtual void ObserveImp(Diadem::StringConstant name, const Diadem::Value &v)
+    { ++count_; }
+};
+
+}  // namespace
+
+// Checkboxes send notifications when their values change.
+TEST_F(HeadlessTest, CheckValue) {
+  ASSERT_TRUE(ReadWindowData(
+      "<window text='CheckValue'>"
+        "<check text='Check' name='c'/>"
+      "</window>"));
+
+  Diadem::Entity* const check = window_root_->FindByName("c");
+  CountingObserver observer;
+
+  window_root_->GetChangeMessenger()->AddObserver(
+      check->GetPropertyPath(Diadem::kPropValue).Get(), &observer);
+  EXPECT_EQ(0, check->GetProperty(Diadem::kPropValue).Coerce<int32_t>());
+  check->SetProperty(Diadem::kPropValue, true);
+  EXPECT_EQ(1, check->GetProperty(Diadem::kPropValue).Coerce<int32_t>());
+  EXPECT_EQ(1, observer.count_);
+  check->SetProperty(Diadem::kPropValue, true);
+  EXPECT_EQ(1, observer.count_);
+  window_root_->GetChangeMessenger()->RemoveObserver(&observer);
+}
+
+namespace {
+
+bool AllowClose(Diadem::Window *window, void *data) {
+  return *static_cast<bool*>(data);
+}
+
+}  // namespace
+
+// TestClose asks the window's close callback.
+TEST_F(HeadlessTest, Close) {
+  ASSERT_TRUE(ReadWindowData("<window text='Close'/>"));
+
+  Diadem::WindowInterface* const window =
+      window_root_->GetNative()->GetWindowInterface();
+  bool allow = false;
+
+  EXPECT_TRUE(
+      window_root_->GetNativeProperty(Diadem::kPropVisible).Coerce<bool>());
+  window_object_->SetCloseCallback(&AllowClose, &allow);
+  window->TestClose();
+  EXPECT_TRUE(
+      window_root_->GetNativeProperty(Diadem::kPropVisible).Coerce<bool>());
+  allow = true;
+  window->TestClose();
+  EXPECT_FALSE(
+      window_root_->GetNativeProperty(Diadem::kPropVisible).Coerce<bool>());
+}
+
+namespace {
+
+const char kThreadedWindow[] =
+    "<window text='Threaded' direction='column'>"
+      "<labelgroup text='Name:'><edit widthName='w'/></labelgroup>"
+      "<labelgroup text='A longer label:'><edit widthName='w'/></labelgroup>"
+      "<multi><group><check text='One'/><radio text='Two'/></group>"
+        "<group><popup><item text='Item'/></popup></group></multi>"
+      "<label text='Some text that wraps when it is narrow' width='fill'/>"
+      "<group><button text='Cancel'/><button text='OK'/></group>"
+    "</window>";
+
+// Appends the size and location of every object in the window.
+void GetGeometry(Diadem::Entity *entity, Diadem::Array<int32_t> *geometry) {
+  Diadem::Layout* const layout = entity->GetLayout();
+
+  if (layout != NULL) {
+    geometry->push_back(layout->GetSize().width);
+    geometry->push_back(layout->GetSize().height);
+    geometry->push_back(layout->GetLocation().x);
+    geometry->push_back(layout->GetLocation().y);
+  }
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    GetGeometry(entity->ChildAt(i), geometry);
+}
+
+// Loads a window, lays it out at a few sizes, and records the results.
+class LayoutTask : public Diadem::ThreadPool::Task {
+ public:
+  explicit LayoutTask(const Diadem::Factory &factory) : factory_(factory) {}
+
+  virtual void Run() {
+    Diadem::Entity* const root =
+        Diadem::LibXMLParser(factory_).LoadEntityFromData(kThreadedWindow);
+
+    if (root == NULL)
+      return;
+
+    Diadem::Layout* const layout = root->GetLayout();
+
+    layout->ResizeToMinimum();
+    GetGeometry(root, &geometry_);
+    for (int32_t width = 200; width <= 400; width += 50) {
+      layout->SetSize(Diadem::Size(width, layout->GetSize().height));
+      layout->UpdateLayout();
+      GetGeometry(root, &geometry_);
+    }
+    delete root;
+  }
+
+  Diadem::Array<int32_t> geometry_;
+
+ protected:
+  const Diadem::Factory &factory_;
+};
+
+}  // namespace
+
+// Windows can be loaded and laid out on several threads at once, with the
+// same results as on one thread.
+TEST_F(HeadlessTest, Threads) {
+  Diadem::Factory factory;
+
+  xmlInitParser();
+  Headless::SetUpFactory(&factory);
+
+  LayoutTask expected(factory);
+
+  expected.Run();
+  ASSERT_FALSE(expected.geometry_.empty());
+
+  Diadem::ThreadPool pool(4);
+  Diadem::Array<LayoutTask*> tasks;
+  Diadem::Array<Diadem::ThreadPool::Task*> task_pointers;
+
+  for (size_t i = 0; i < 64; ++i) {
+    tasks.push_back(new LayoutTask(factory));
+    task_pointers.push_back(tasks.back());
+  }
+  pool.Run(task_pointers);
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    EXPECT_TRUE(expected.geometry_ == tasks[i]->geometry_);
+    delete tasks[i];
+  }
+}
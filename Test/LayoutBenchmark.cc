@@ -0,0 +1,412 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Times loading and laying out generated documents of 10 to 100,000 entities,
+// with each phase timed separately and the memory allocations it makes
+// counted. The native objects are the headless ones, so the results don't
+// depend on a window system. Counting replaces the global operator new and
+// delete, so this is built as its own Benchmark target rather than as part
+// of the tests. The benchmarks are disabled by default; run them with:
+//   --gtest_also_run_disabled_tests --gtest_filter=LayoutBenchmark.*
+
+#include <gtest/gtest.h>
+
+#include <libxml/parser.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <new>
+#include <string>
+
+#include "Diadem/ChangeMessenger.h"
+#include "Diadem/CompiledParser.h"
+#include "Diadem/Factory.h"
+#include "Diadem/Layout.h"
+#include "Diadem/LibXMLCompiler.h"
+#include "Diadem/NativeHeadless.h"
+#include "Diadem/Value.h"
+#include "Diadem/WindowTemplate.h"
+
+namespace {
+
+size_t allocation_count = 0;
+
+}  // namespace
+
+// Every allocation in the program is counted, so the count for a phase is
+// the difference between before and after. Only operator delete has an
+// exception specification, since the C++98 one for operator new is not
+// allowed from C++17 on. The operators are kept out of line so that the
+// compiler doesn't see memory from operator new being passed to free().
+#if __cplusplus >= 201103L
+#define BENCHMARK_NOTHROW noexcept
+#else
+#define BENCHMARK_NOTHROW throw()
+#endif
+
+#ifdef __GNUC__
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#else
+#define BENCHMARK_NOINLINE
+#endif
+
+BENCHMARK_NOINLINE void* operator new(size_t size) {
+  Diadem::AtomicAdd<size_t>(&allocation_count, 1);
+
+  void* const result = malloc((size == 0) ? 1 : size);
+
+  if (result == NULL)
+    throw std::bad_alloc();
+  return result;
+}
+
+BENCHMARK_NOINLINE void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+BENCHMARK_NOINLINE void operator delete(void *p) BENCHMARK_NOTHROW {
+  free(p);
+}
+
+BENCHMARK_NOINLINE void operator delete[](void *p) BENCHMARK_NOTHROW {
+  free(p);
+}
+
+#ifdef __cpp_sized_deallocation
+BENCHMARK_NOINLINE void operator delete(void *p, size_t) BENCHMARK_NOTHROW {
+  free(p);
+}
+
+BENCHMARK_NOINLINE void operator delete[](void *p, size_t) BENCHMARK_NOTHROW {
+  free(p);
+}
+#endif
+
+namespace {
+
+// The shapes of generated documents.
+enum Shape {
+  kShapeWide,    // One long column of controls
+  kShapeDeep,    // Chains of nested groups
+  kShapeForm,    // Label groups, with the controls sharing width names
+  kShapePanels,  // Multipanels with several panels of controls
+};
+
+const char* ShapeName(Shape shape) {
+  switch (shape) {
+    case kShapeWide:   return "wide";
+    case kShapeDeep:   return "deep";
+    case kShapeForm:   return "form";
+    case kShapePanels: return "panels";
+  }
+  return "";
+}
+
+// libxml2 limits the nesting depth of documents.
+const int kMaxChainDepth = 50;
+
+std::string Number(size_t n) {
+  char buffer[24];
+
+  snprintf(buffer, sizeof(buffer), "%lu", static_cast<unsigned long>(n));
+  return buffer;
+}
+
+// Appends a control, with a name so that its changes can be observed.
+void AppendControl(size_t index, std::string *document) {
+  const std::string n = Number(index);
+
+  switch (index % 4) {
+    case 0:
+      *document += "<label width='fill' name='c" + n + "' text='Label " + n +
+          " with some text to wrap'/>";
+      break;
+    case 1:
+      *document += "<button name='c" + n + "' text='Button " + n + "'/>";
+      break;
+    case 2:
+      *document += "<check name='c" + n + "' text='Check " + n + "'/>";
+      break;
+    case 3:
+      *document += "<edit width='fill' name='c" + n + "' text='" + n + "'/>";
+      break;
+  }
+}
+
+// Generates a document with about the given number of entities.
+std::string MakeDocument(Shape shape, size_t entity_count) {
+  std::string document =
+      "<window text='Benchmark' direction='column' width='60em'>";
+  size_t count = 1;
+
+  switch (shape) {
+    case kShapeWide:
+      while (count < entity_count)
+        AppendControl(count++, &document);
+      break;
+    case kShapeDeep:
+      while (count < entity_count) {
+        int depth = 0;
+
+        for (; (depth < kMaxChainDepth) && (count < entity_count); ++depth) {
+          document += (depth % 2 == 0) ?
+              "<group width='fill'>" : "<group direction='column'>";
+          AppendControl(count + 1, &document);
+          count += 2;
+        }
+        for (; depth > 0; --depth)
+          document += "</group>";
+      }
+      break;
+    case kShapeForm:
+      // A label group has a label and a content group besides the control.
+      while (count < entity_count) {
+        document += "<labelgroup text='Field " + Number(count) + ":'>"
+            "<edit width='fill' widthName='w" + Number(count % 4) +
+            "' name='c" + Number(count) + "' text='" + Number(count) + "'/>"
+            "</labelgroup>";
+        count += 4;
+      }
+      break;
+    case kShapePanels:
+      while (count < entity_count) {
+        document += "<multi width='fill'>";
+        ++count;
+        for (int panel = 0; panel < 3; ++panel) {
+          document += "<group direction='column'>";
+          ++count;
+          for (int i = 0; i < 3; ++i)
+            AppendControl(count++, &document);
+          document += "</group>";
+        }
+        document += "</multi>";
+      }
+      break;
+  }
+  document += "</window>";
+  return document;
+}
+
+// The parsed document, in the order the FactorySession would be given it.
+struct ParsedElement {
+  Diadem::TypeName name;
+  Diadem::PropertyMap properties;
+  size_t child_count;
+};
+
+void ParseElement(xmlNode *element, Diadem::Array<ParsedElement> *elements) {
+  ParsedElement parsed;
+
+  parsed.name = Diadem::TypeName((const char*)element->name);
+  parsed.child_count = 0;
+  for (xmlAttr *attr = element->properties; attr != NULL; attr = attr->next)
+    parsed.properties.Insert(
+        (const char*)attr->name,
+        (const char*)attr->children->content);
+  for (xmlNode *child = element->children; child != NULL; child = child->next)
+    if (child->type == XML_ELEMENT_NODE)
+      ++parsed.child_count;
+  elements->push_back(parsed);
+  for (xmlNode *child = element->children; child != NULL; child = child->next)
+    if (child->type == XML_ELEMENT_NODE)
+      ParseElement(child, elements);
+}
+
+// Creates the entities like FactorySession does, but without finalizing
+// them, so that the two can be timed separately.
+Diadem::Entity* CreateEntities(
+    const Diadem::Factory &factory,
+    const Diadem::Array<ParsedElement> &elements,
+    size_t *index) {
+  const ParsedElement &element = elements[(*index)++];
+  Diadem::Entity* const entity =
+      factory.CreateEntity(element.name, element.properties);
+
+  for (size_t i = 0; i < element.child_count; ++i) {
+    Diadem::Entity* const child = CreateEntities(factory, elements, index);
+
+    if (child != NULL)
+      entity->AddChild(child);
+  }
+  return entity;
+}
+
+size_t CountEntities(const Diadem::Entity *entity) {
+  size_t count = 1;
+
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    count += CountEntities(entity->ChildAt(i));
+  return count;
+}
+
+class CountingObserver : public Diadem::ValueObserver {
+ public:
+  CountingObserver() : count_(0) {}
+
+  size_t count_;
+
+ protected:
+  virtual void ObserveImp(Diadem::StringConstant name, const Diadem::Value &v)
+    { ++count_; }
+};
+
+// Times a phase of the benchmark and counts its allocations.
+class Phase {
+ public:
+  explicit Phase(const char *name)
+      : name_(name), start_(clock()), allocations_(allocation_count) {}
+  ~Phase() {
+    printf("  %-16s %10.2f ms %10lu allocations\n",
+           name_, (clock() - start_) * 1000.0 / CLOCKS_PER_SEC,
+           static_cast<unsigned long>(allocation_count - allocations_));
+  }
+
+ protected:
+  const char *name_;
+  clock_t start_;
+  size_t allocations_;
+};
+
+void RunBenchmark(Shape shape, size_t entity_count) {
+  Diadem::Factory factory;
+  const std::string document = MakeDocument(shape, entity_count);
+  Diadem::Array<ParsedElement> elements;
+  Diadem::Entity *root = NULL;
+
+  Diadem::Headless::SetUpFactory(&factory);
+  factory.Seal();
+  printf("%s, %lu entities\n", ShapeName(shape),
+         static_cast<unsigned long>(entity_count));
+  {
+    Phase phase("parse");
+    xmlDocPtr xml = xmlParseMemory(document.c_str(), document.size());
+
+    ASSERT_TRUE(xml != NULL);
+    ParseElement(xmlDocGetRootElement(xml), &elements);
+    xmlFreeDoc(xml);
+  }
+  {
+    Phase phase("CreateEntity");
+    size_t index = 0;
+
+    root = CreateEntities(factory, elements, &index);
+  }
+  ASSERT_TRUE(root != NULL);
+  {
+    Phase phase("FactoryFinalize");
+
+    root->FactoryFinalize();
+  }
+
+  Diadem::Layout* const layout = root->GetLayout();
+
+  {
+    Phase phase("ResizeToMinimum");
+
+    layout->ResizeToMinimum();
+  }
+  {
+    Phase phase("resize x20");
+    Diadem::Size size = layout->GetSize();
+
+    for (int i = 0; i < 20; ++i) {
+      size.width += 10;
+      size.height += 10;
+      layout->SetSize(size);
+    }
+  }
+
+  Diadem::Array<Diadem::Entity*> controls;
+  CountingObserver observer;
+  const size_t count = CountEntities(root);
+
+  for (size_t i = 0; i < count; ++i) {
+    Diadem::Entity* const control =
+        root->FindByName(("c" + Number(i)).c_str());
+
+    if (control != NULL) {
+      controls.push_back(control);
+      root->GetChangeMessenger()->AddObserver(
+          control->GetPropertyPath(Diadem::kPropValue).Get(), &observer);
+    }
+  }
+  {
+    Phase phase("notify");
+
+    for (size_t i = 0; i < controls.size(); ++i)
+      controls[i]->PropertyChanged(Diadem::kPropValue);
+  }
+  EXPECT_EQ(controls.size(), observer.count_);
+  root->GetChangeMessenger()->RemoveObserver(&observer);
+  {
+    Phase phase("delete");
+
+    delete root;
+  }
+
+  // Loading a compiled copy replaces parse, CreateEntity and
+  // FactoryFinalize.
+  Diadem::Array<char> compiled;
+
+  ASSERT_TRUE(
+      Diadem::LibXMLCompiler().CompileData(document.c_str(), &compiled));
+  {
+    Phase phase("compiled load");
+
+    root = Diadem::CompiledParser(factory).LoadEntityFromData(
+        &compiled[0], compiled.size());
+  }
+  ASSERT_TRUE(root != NULL);
+  delete root;
+
+  // Creating from a template skips loading the resource as well.
+  Diadem::WindowTemplate* const window_template =
+      Diadem::WindowTemplate::LoadFromData(factory, document.c_str());
+
+  ASSERT_TRUE(window_template != NULL);
+  {
+    Phase phase("template create");
+
+    root = window_template->CreateEntity();
+  }
+  delete window_template;
+  ASSERT_TRUE(root != NULL);
+  delete root;
+}
+
+const size_t kEntityCounts[] = { 10, 1000, 10000, 100000 };
+
+void RunSizes(Shape shape) {
+  for (size_t i = 0; i < sizeof(kEntityCounts) / sizeof(kEntityCounts[0]); ++i)
+    RunBenchmark(shape, kEntityCounts[i]);
+}
+
+}  // namespace
+
+TEST(LayoutBenchmark, DISABLED_Wide) {
+  RunSizes(kShapeWide);
+}
+
+TEST(LayoutBenchmark, DISABLED_Deep) {
+  RunSizes(kShapeDeep);
+}
+
+TEST(LayoutBenchmark, DISABLED_Form) {
+  RunSizes(kShapeForm);
+}
+
+TEST(LayoutBenchmark, DISABLED_Panels) {
+  RunSizes(kShapePanels);
+}
@@ -12,13 +12,18 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <vector>
+
 #include "Diadem/Test/WindowTestBase.h"
 #include "Diadem/Layout.h"
 #include "Diadem/Native.h"
 #include "Diadem/Value.h"
 
-// Layout tests that do not involve nested containers.
+// Layout tests that do not involve nested containers. Each window is also
+// checked against FlatLayout when the test finishes.
 class LayoutTest : public WindowTestBase {
+ public:
+  LayoutTest() { compareFlatLayout_ = true; }
 };
 
 // A row where one object has its width set to fill.
@@ -478,6 +483,26 @@ TEST_F(LayoutTest, testNamedWidth2) {
   EXPECT_EQ(size4.width, size3.width);
 }
 
+// Controls of different heights with the same heightName
+TEST_F(LayoutTest, testNamedHeight) {
+  ReadWindowData(
+      "<window text='testNamedHeight' direction='row'>"
+        "<label text='Name:' heightName='h'/>"
+        "<button text='Button' heightName='h'/>"
+      "</window>");
+  ASSERT_EQ(2, windowRoot_->ChildrenCount());
+
+  Diadem::Entity* const label = windowRoot_->ChildAt(0);
+  Diadem::Entity* const button = windowRoot_->ChildAt(1);
+  const Diadem::Size label_size =
+      label->GetProperty(Diadem::kPropSize).Coerce<Diadem::Size>();
+  const Diadem::Size button_size =
+      button->GetProperty(Diadem::kPropSize).Coerce<Diadem::Size>();
+
+  EXPECT_GT(label_size.height, 0);
+  EXPECT_EQ(button_size.height, label_size.height);
+}
+
 // A paragraph wrapped to a specific width
 TEST_F(LayoutTest, testParagraph) {
   ReadWindowData(
@@ -535,3 +560,222 @@ TEST_F(LayoutTest, testFillInFill) {
 
   EXPECT_EQ(l_size.height, l2_size.height);
 }
+
+// Changing a label's text only invalidates its own branch of the hierarchy,
+// and UpdateLayout brings everything up to date.
+TEST_F(LayoutTest, testUpdateLayout) {
+  ReadWindowData(
+      "<window text='testUpdateLayout' direction='row'>"
+        "<group><label text='A' name='a'/></group>"
+        "<group><label text='B' name='b'/></group>"
+      "</window>");
+  ASSERT_EQ(2, windowRoot_->ChildrenCount());
+
+  Diadem::Layout* const group_aL = windowRoot_->ChildAt(0)->GetLayout();
+  Diadem::Layout* const group_bL = windowRoot_->ChildAt(1)->GetLayout();
+  Diadem::Layout* const label_aL = windowRoot_->FindByName("a")->GetLayout();
+  const Diadem::Size a_size = label_aL->GetSize();
+  const Diadem::Location b_loc = group_bL->GetLocation();
+
+  EXPECT_FALSE(windowObject_->NeedsLayout());
+  windowRoot_->FindByName("a")->SetText("A much longer label");
+  EXPECT_TRUE(windowObject_->NeedsLayout());
+  EXPECT_TRUE(group_aL->NeedsLayout());
+  EXPECT_FALSE(group_bL->NeedsLayout());
+
+  windowObject_->UpdateLayout();
+  EXPECT_FALSE(windowObject_->NeedsLayout());
+  EXPECT_FALSE(group_aL->NeedsLayout());
+  EXPECT_LT(a_size.width, label_aL->GetSize().width);
+  EXPECT_LT(b_loc.x, group_bL->GetLocation().x);
+}
+
+// Layout passes that don't change anything don't measure anything, and a
+// change only measures the objects it affects.
+TEST_F(LayoutTest, testMeasurementCache) {
+  ReadWindowData(
+      "<window text='testMeasurementCache' direction='column'>"
+        "<label text='A' name='a'/>"
+        "<label text='B'/>"
+        "<label text='C'/>"
+      "</window>");
+
+  Diadem::Layout::ResetMeasurementCounts();
+  windowRoot_->GetLayout()->ResizeToMinimum();
+  windowObject_->UpdateLayout();
+  EXPECT_EQ(0u, Diadem::Layout::GetMeasurementCounts().measured);
+
+  windowRoot_->FindByName("a")->SetText("A longer label");
+  windowObject_->UpdateLayout();
+  EXPECT_LT(0u, Diadem::Layout::GetMeasurementCounts().measured);
+  // Only the changed label is measured, once before and once after its
+  // width changes.
+  EXPECT_GE(2u, Diadem::Layout::GetMeasurementCounts().measured);
+}
+
+// Objects with the same width name stay the same width when one of them
+// changes.
+TEST_F(LayoutTest, testWidthNameUpdate) {
+  ReadWindowData(
+      "<window text='testWidthNameUpdate' direction='column'>"
+        "<group><label text='A' name='a' widthName='w'/></group>"
+        "<group><label text='B' name='b' widthName='w'/></group>"
+      "</window>");
+
+  Diadem::Layout* const label_aL = windowRoot_->FindByName("a")->GetLayout();
+  Diadem::Layout* const label_bL = windowRoot_->FindByName("b")->GetLayout();
+  const int32_t old_width = label_bL->GetSize().width;
+
+  EXPECT_EQ(label_aL->GetSize().width, old_width);
+  windowRoot_->FindByName("a")->SetText("A much longer label");
+  windowObject_->UpdateLayout();
+  EXPECT_LT(old_width, label_bL->GetSize().width);
+  EXPECT_EQ(label_aL->GetSize().width, label_bL->GetSize().width);
+}
+
+// Geometry set during a GeometryBatch is held until the batch ends.
+TEST_F(LayoutTest, testGeometryBatch) {
+  ReadWindowData(
+      "<window text='testGeometryBatch'>"
+        "<label text='A' name='a'/>"
+      "</window>");
+
+  Diadem::Entity* const label_a = windowRoot_->FindByName("a");
+  Diadem::Layout* const label_aL = label_a->GetLayout();
+  const Diadem::Location old_loc = label_aL->GetLocation();
+  const Diadem::Location new_loc(old_loc.x + 10, old_loc.y + 10);
+
+  {
+    Diadem::GeometryBatch batch(windowRoot_->GetLayout());
+
+    label_aL->SetLocation(new_loc);
+    EXPECT_EQ(new_loc, label_aL->GetLocation());
+    EXPECT_EQ(old_loc,
+              label_a->GetNativeProperty(Diadem::kPropLocation)
+                  .Coerce<Diadem::Location>());
+  }
+  EXPECT_EQ(new_loc,
+            label_a->GetNativeProperty(Diadem::kPropLocation)
+                .Coerce<Diadem::Location>());
+}
+
+namespace {
+
+class RecordingMonitor : public Diadem::LayoutMonitor {
+ public:
+  RecordingMonitor() : passes_(0), finished_(0), not_converged_(0) {}
+
+  virtual void LayoutRepeated(
+      const Diadem::Layout *container, const Diadem::Layout *child) {
+    repeated_containers_.push_back(container);
+    repeated_children_.push_back(child);
+  }
+  virtual void LayoutFinished(
+      const Diadem::Layout *container, size_t iterations, bool converged) {
+    ++finished_;
+    if (!converged)
+      ++not_converged_;
+  }
+  virtual void PassFinished(
+      const Diadem::Layout *root, size_t iterations, bool converged) {
+    ++passes_;
+    if (!converged)
+      ++not_converged_;
+  }
+
+  int passes_, finished_, not_converged_;
+  std::vector<const Diadem::Layout*> repeated_containers_, repeated_children_;
+};
+
+}  // namespace
+
+// The layout monitor hears about each pass, and about wrapped text causing
+// its group to repeat its layout.
+TEST_F(LayoutTest, testLayoutMonitor) {
+  ReadWindowData(
+      "<window text='testLayoutMonitor' direction='column'>"
+        "<label name='heading' text='Heading'/>"
+        "<group width='fill' name='group'>"
+          "<label width='fill' name='text' text='Lorem ipsum dolor sit amet, "
+              "consectetur adipisici elit, sed do eiusmod tempor.'/>"
+          "<button text='OK'/>"
+        "</group>"
+      "</window>");
+
+  RecordingMonitor monitor;
+  Diadem::Layout* const root_layout = windowRoot_->GetLayout();
+
+  // A wider heading widens the group, and the text wraps onto fewer lines
+  // once the group sets its new width.
+  Diadem::Layout::SetMonitor(&monitor);
+  windowRoot_->FindByName("heading")->SetText(
+      "A heading that is much wider than it was before");
+  root_layout->ResizeToMinimum();
+  Diadem::Layout::SetMonitor(NULL);
+
+  EXPECT_EQ(1, monitor.passes_);
+  EXPECT_LT(0, monitor.finished_);
+  EXPECT_EQ(0, monitor.not_converged_);
+  ASSERT_FALSE(monitor.repeated_children_.empty());
+  EXPECT_EQ(windowRoot_->FindByName("group")->GetLayout(),
+            monitor.repeated_containers_[0]);
+  EXPECT_EQ(windowRoot_->FindByName("text")->GetLayout(),
+            monitor.repeated_children_[0]);
+
+  // Nothing is reported after the monitor is removed.
+  Diadem::Size larger = root_layout->GetSize();
+
+  larger.width += 10;
+  root_layout->SetSize(larger);
+  EXPECT_EQ(1, monitor.passes_);
+}
+
+namespace {
+
+void GetGeometry(Diadem::Entity *entity, std::vector<int32_t> *geometry) {
+  const Diadem::Layout* const layout = entity->GetLayout();
+
+  if (layout != NULL) {
+    geometry->push_back(layout->GetSize().width);
+    geometry->push_back(layout->GetSize().height);
+    geometry->push_back(layout->GetLocation().x);
+    geometry->push_back(layout->GetLocation().y);
+  }
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    GetGeometry(entity->ChildAt(i), geometry);
+}
+
+}  // namespace
+
+// Resizing a window without changing its contents gives the same result as
+// a full layout at the new size.
+TEST_F(LayoutTest, testQuickResize) {
+  ReadWindowData(
+      "<window text='testQuickResize' direction='column'>"
+        "<group width='fill'>"
+          "<label text='Name:'/>"
+          "<edit width='fill' text='Fill'/>"
+        "</group>"
+        "<label width='fill' text='Some text that wraps when the window is "
+            "narrow enough'/>"
+        "<button text='Center' align='center'/>"
+        "<button text='End' align='end'/>"
+      "</window>");
+
+  Diadem::Layout* const root_layout = windowRoot_->GetLayout();
+  Diadem::Size size = root_layout->GetSize();
+  std::vector<int32_t> quick, full;
+
+  for (int i = 0; i < 3; ++i) {
+    size.width += 25;
+    size.height += 10;
+    root_layout->SetSize(size);
+    quick.clear();
+    GetGeometry(windowRoot_, &quick);
+    root_layout->InvalidateLayout();
+    root_layout->SetSize(size);
+    full.clear();
+    GetGeometry(windowRoot_, &full);
+    EXPECT_EQ(full, quick);
+  }
+}
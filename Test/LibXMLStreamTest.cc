@@ -0,0 +1,72 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "XMLTest.h"
+#include "Diadem/Factory.h"
+#include "Diadem/LibXMLStreamParser.h"
+
+namespace {
+
+class LibXMLStreamTest : public XMLTest {
+ public:
+  Diadem::Parser* MakeParser(const Diadem::Factory &factory)
+    { return new Diadem::LibXMLStreamParser(factory); }
+};
+
+XML_TESTS(LibXMLStreamTest)
+
+// Files are read in pieces, so entities may be split between them.
+TEST_F(LibXMLStreamTest, File) {
+  char path[] = "/tmp/LibXMLStreamTestXXXXXX";
+  const int fd = mkstemp(path);
+
+  ASSERT_NE(-1, fd);
+
+  const size_t kChildCount = 5000;
+  std::string document = "<entity name='outside'>";
+
+  for (size_t i = 0; i < kChildCount; ++i)
+    document += "<entity name='inside'><entity name='innermost'/></entity>";
+  document += "</entity>";
+  ASSERT_EQ((ssize_t)document.size(),
+            write(fd, document.data(), document.size()));
+  close(fd);
+
+  Diadem::Factory factory;
+
+  factory.Register<Diadem::Entity>("entity");
+
+  Diadem::LibXMLStreamParser parser(factory);
+  Diadem::Entity *result = parser.LoadEntityFromFile(path);
+
+  unlink(path);
+  ASSERT_NE((Diadem::Entity*)NULL, result);
+  ASSERT_EQ(kChildCount, result->ChildrenCount());
+  for (size_t i = 0; i < kChildCount; ++i) {
+    ASSERT_STREQ("inside", result->ChildAt(i)->GetName());
+    ASSERT_EQ(1, result->ChildAt(i)->ChildrenCount());
+  }
+  delete result;
+  EXPECT_EQ((Diadem::Entity*)NULL,
+            parser.LoadEntityFromFile("/nonexistent/file.dem"));
+}
+
+}  // namespace
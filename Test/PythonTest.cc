@@ -233,6 +233,108 @@ TEST_F(PythonTest, GetSetByName) {
   EXPECT_STREQ("BBB", textB.Get());
 }
 
+namespace {
+
+class CountingObserver : public Diadem::ValueObserver {
+ public:
+  CountingObserver() : count_(0) {}
+
+  int count_;
+  Diadem::Value last_value_;
+
+ protected:
+  virtual void ObserveImp(Diadem::StringConstant name, const Diadem::Value &v) {
+    ++count_;
+    last_value_ = v;
+  }
+};
+
+}  // namespace
+
+// Tests holding change notifications with BeginChanges/CommitChanges.
+TEST_F(PythonTest, Transaction) {
+  PyObject *result = PyRun_String(
+      "window = pyadem.Window(data=\""
+        "<window>"
+          "<check name='A' text='A'/>"
+          "<check name='B' text='B'/>"
+        "</window>\")\n",
+      Py_file_input, globals_, locals_);
+  PyObject *error = PyErr_Occurred();
+
+  if (error != NULL) {
+    PyErr_Print();
+    PyErr_Clear();
+    FAIL();
+  }
+  ASSERT_FALSE(result == NULL);
+
+  PyademEntity *window = (PyademEntity*)PyDict_GetItemString(locals_, "window");
+
+  ASSERT_FALSE(window == NULL);
+  ASSERT_TRUE(PyObject_TypeCheck(window, &EntityType));
+
+  Diadem::ChangeMessenger* const messenger =
+      window->object->GetChangeMessenger();
+  Diadem::Entity* const checkA = window->object->FindByName("A");
+  Diadem::Entity* const checkB = window->object->FindByName("B");
+  CountingObserver observerA, observerB;
+
+  ASSERT_FALSE(messenger == NULL);
+  ASSERT_FALSE(checkA == NULL);
+  ASSERT_FALSE(checkB == NULL);
+  messenger->AddObserver(
+      checkA->GetPropertyPath(Diadem::kPropValue).Get(), &observerA);
+  messenger->AddObserver(
+      checkB->GetPropertyPath(Diadem::kPropValue).Get(), &observerB);
+
+  // Nothing is delivered until the changes are committed
+  result = PyRun_String(
+      "window.BeginChanges()\n"
+      "window.SetPropertyByName(\"A\", pyadem.PROP_VALUE, 1)\n"
+      "window.SetPropertyByName(\"B\", pyadem.PROP_VALUE, 1)\n"
+      "window.SetPropertyByName(\"A\", pyadem.PROP_VALUE, 0)\n",
+      Py_file_input, globals_, locals_);
+  error = PyErr_Occurred();
+  if (error != NULL) {
+    PyErr_Print();
+    PyErr_Clear();
+    FAIL();
+  }
+  ASSERT_FALSE(result == NULL);
+  EXPECT_TRUE(messenger->InTransaction());
+  EXPECT_EQ(0, observerA.count_);
+  EXPECT_EQ(0, observerB.count_);
+
+  // Each observer hears once, with the final value
+  result = PyRun_String(
+      "window.CommitChanges()\n",
+      Py_file_input, globals_, locals_);
+  error = PyErr_Occurred();
+  if (error != NULL) {
+    PyErr_Print();
+    PyErr_Clear();
+    FAIL();
+  }
+  ASSERT_FALSE(result == NULL);
+  EXPECT_FALSE(messenger->InTransaction());
+  EXPECT_EQ(1, observerA.count_);
+  EXPECT_EQ(1, observerB.count_);
+  EXPECT_EQ(0, observerA.last_value_.Coerce<int32_t>());
+  EXPECT_EQ(1, observerB.last_value_.Coerce<int32_t>());
+
+  // Committing without beginning is an error
+  result = PyRun_String(
+      "window.CommitChanges()\n",
+      Py_file_input, globals_, locals_);
+  EXPECT_TRUE(result == NULL);
+  EXPECT_FALSE(PyErr_Occurred() == NULL);
+  PyErr_Clear();
+
+  messenger->RemoveObserver(&observerA);
+  messenger->RemoveObserver(&observerB);
+}
+
 // Tests the button callback calling a Python function.
 TEST_F(PythonTest, ButtonCallback) {
   PyObject *result = PyRun_String(
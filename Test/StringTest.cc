@@ -0,0 +1,104 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+
+#include "Diadem/Wrappers.h"
+
+TEST(StringTest, CopiesShareCharacters) {
+  const Diadem::String a("shared");
+  Diadem::String b(a), c;
+
+  c = b;
+  EXPECT_EQ(a.Get(), b.Get());
+  EXPECT_EQ(a.Get(), c.Get());
+  EXPECT_EQ(6u, c.Length());
+  c = "other";
+  EXPECT_STREQ("other", c);
+  EXPECT_STREQ("shared", a);
+  c = c.Get() + 1;  // Assigning from the string's own characters
+  EXPECT_STREQ("ther", c);
+}
+
+TEST(StringTest, Empty) {
+  const Diadem::String a, b(""), c(static_cast<const char*>(NULL));
+
+  EXPECT_TRUE(a.IsEmpty());
+  EXPECT_TRUE(b.IsEmpty());
+  EXPECT_TRUE(c.IsEmpty());
+  EXPECT_STREQ("", a.Get());
+  EXPECT_EQ(0u, b.Length());
+  EXPECT_TRUE(a == b);
+}
+
+TEST(StringTest, Adopt) {
+  char *buffer = new char[6];
+
+  strcpy(buffer, "adopt");
+
+  const Diadem::String a(buffer, Diadem::String::kAdoptBuffer);
+  const Diadem::String b(a);
+
+  EXPECT_EQ(buffer, a.Get());
+  EXPECT_EQ(buffer, b.Get());
+  EXPECT_EQ(5u, b.Length());
+}
+
+TEST(StringTest, Compare) {
+  const Diadem::String a("abc"), b("abc"), c("abd"), d("abcd");
+
+  EXPECT_TRUE(a == b);
+  EXPECT_EQ(a.Hash(), b.Hash());
+  EXPECT_TRUE(a != c);
+  EXPECT_TRUE(a != d);
+  EXPECT_TRUE(a == "abc");
+  EXPECT_TRUE(a < c);
+}
+
+namespace {
+
+class CountedStorage : public Diadem::SharedStorage {
+ public:
+  explicit CountedStorage(bool *deleted) : deleted_(deleted) {}
+
+ protected:
+  ~CountedStorage() { *deleted_ = true; }
+
+  bool *deleted_;
+};
+
+}  // namespace
+
+TEST(StringTest, SharedStorage) {
+  static const char kCharacters[] = "stored";
+  bool deleted = false;
+  CountedStorage* const storage = new CountedStorage(&deleted);
+  size_t length;
+  const uint32_t hash = Diadem::String::ComputeHash(kCharacters, &length);
+
+  {
+    Diadem::String *a = new Diadem::String(kCharacters, length, hash, storage);
+    const Diadem::String b(*a), c(kCharacters);
+
+    storage->Release();
+    EXPECT_EQ(kCharacters, a->Get());
+    EXPECT_TRUE(*a == c);
+    delete a;
+    EXPECT_FALSE(deleted);
+    EXPECT_EQ(kCharacters, b.Get());
+    EXPECT_EQ(hash, b.Hash());
+    EXPECT_EQ(6u, b.Length());
+  }
+  EXPECT_TRUE(deleted);
+}
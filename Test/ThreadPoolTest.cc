@@ -0,0 +1,58 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+
+#include "Diadem/ThreadPool.h"
+
+namespace {
+
+class CountTask : public Diadem::ThreadPool::Task {
+ public:
+  CountTask() : count_(0) {}
+
+  virtual void Run() { ++count_; }
+
+  int count_;
+};
+
+void RunTasks(Diadem::ThreadPool *pool, size_t task_count) {
+  Diadem::Array<CountTask> tasks;
+  Diadem::Array<Diadem::ThreadPool::Task*> task_pointers;
+
+  tasks.resize(task_count);
+  for (size_t i = 0; i < tasks.size(); ++i)
+    task_pointers.push_back(&tasks[i]);
+  pool->Run(task_pointers);
+  for (size_t i = 0; i < tasks.size(); ++i)
+    EXPECT_EQ(1, tasks[i].count_);
+}
+
+}  // namespace
+
+TEST(ThreadPoolTest, RunsEachTaskOnce) {
+  Diadem::ThreadPool pool(3);
+
+  EXPECT_EQ(3u, pool.ThreadCount());
+  // Repeated batches of different sizes, including ones with fewer tasks
+  // than threads.
+  for (size_t i = 0; i < 100; ++i)
+    RunTasks(&pool, i % 20);
+}
+
+TEST(ThreadPoolTest, ThreadPerProcessor) {
+  Diadem::ThreadPool pool;
+
+  RunTasks(&pool, 50);
+}
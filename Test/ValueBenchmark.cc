@@ -0,0 +1,109 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares Value::Coerce against the RTTI-based path it replaced. These are
+// disabled by default; run them with:
+//   --gtest_also_run_disabled_tests --gtest_filter=ValueBenchmark.*
+
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include "Diadem/Value.h"
+
+namespace {
+
+const int kIterations = 5000000;
+
+// Exposes the old dynamic_cast and virtual call path for comparison.
+class BenchmarkValue : public Diadem::Value {
+ public:
+  template <class T>
+  explicit BenchmarkValue(const T &t) : Value(t) {}
+
+  template <class T>
+  T CoerceWithRTTI() const { return Value::CoerceWithRTTI<T>(); }
+};
+
+double ElapsedMilliseconds(clock_t start) {
+  return (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+// Times extracting the value as its own type and converting it to bool,
+// which every type supports, using both paths.
+template <class T>
+void CompareCoerce(const char *type_name, const T &t) {
+  const BenchmarkValue value(t);
+  volatile bool sink = false;
+  clock_t start;
+
+  start = clock();
+  for (int i = 0; i < kIterations; ++i)
+    sink = sink ^ (value.Coerce<T>() == t);
+  const double same_tag = ElapsedMilliseconds(start);
+
+  start = clock();
+  for (int i = 0; i < kIterations; ++i)
+    sink = sink ^ (value.CoerceWithRTTI<T>() == t);
+  const double same_rtti = ElapsedMilliseconds(start);
+
+  start = clock();
+  for (int i = 0; i < kIterations; ++i)
+    sink = sink ^ value.Coerce<bool>();
+  const double bool_tag = ElapsedMilliseconds(start);
+
+  start = clock();
+  for (int i = 0; i < kIterations; ++i)
+    sink = sink ^ value.CoerceWithRTTI<bool>();
+  const double bool_rtti = ElapsedMilliseconds(start);
+
+  printf("%-10s same type: %8.1f ms (rtti %8.1f ms)"
+         "   to bool: %8.1f ms (rtti %8.1f ms)\n",
+         type_name, same_tag, same_rtti, bool_tag, bool_rtti);
+}
+
+}  // namespace
+
+TEST(ValueBenchmark, DISABLED_Coerce) {
+  printf("%d iterations each\n", kIterations);
+  CompareCoerce("bool", true);
+  CompareCoerce("int32_t", static_cast<int32_t>(-12));
+  CompareCoerce("uint32_t", static_cast<uint32_t>(12));
+  CompareCoerce("int64_t", static_cast<int64_t>(12));
+  CompareCoerce("size_t", static_cast<size_t>(12));
+  CompareCoerce("String", Diadem::String("12"));
+  CompareCoerce("double", 12.5);
+  CompareCoerce("Size", Diadem::Size(12, 34));
+  CompareCoerce("Location", Diadem::Location(12, 34));
+}
+
+// Spacing has no operator==, so it is timed separately.
+TEST(ValueBenchmark, DISABLED_CoerceSpacing) {
+  const BenchmarkValue value(Diadem::Spacing(1, 2, 3, 4));
+  volatile int32_t sink = 0;
+  clock_t start;
+
+  start = clock();
+  for (int i = 0; i < kIterations; ++i)
+    sink = sink + value.Coerce<Diadem::Spacing>().top;
+  const double same_tag = ElapsedMilliseconds(start);
+
+  start = clock();
+  for (int i = 0; i < kIterations; ++i)
+    sink = sink + value.CoerceWithRTTI<Diadem::Spacing>().top;
+  const double same_rtti = ElapsedMilliseconds(start);
+
+  printf("%-10s same type: %8.1f ms (rtti %8.1f ms)\n",
+         "Spacing", same_tag, same_rtti);
+}
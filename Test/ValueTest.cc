@@ -54,3 +54,39 @@ TEST(ValueTest, Assign) {
   value2 = value3;
   EXPECT_FALSE(value2.IsValid());
 }
+
+TEST(ValueTest, AssignInlineAndHeap) {
+  Diadem::Value spacing(Diadem::Spacing(1, 2, 3, 4)), text("text");
+  Diadem::Value copy(spacing);
+
+  EXPECT_TRUE(copy.IsValueType<Diadem::Spacing>());
+  EXPECT_FALSE(Diadem::Spacing(1, 2, 3, 4) != copy.Coerce<Diadem::Spacing>());
+  copy = text;
+  EXPECT_TRUE(copy.IsValueType<Diadem::String>());
+  EXPECT_STREQ("text", copy.Coerce<Diadem::String>().Get());
+  copy = Diadem::Location(5, 6);
+  EXPECT_TRUE(copy.IsValueType<Diadem::Location>());
+  EXPECT_EQ(Diadem::Location(5, 6), copy.Coerce<Diadem::Location>());
+  copy = copy;
+  EXPECT_EQ(Diadem::Location(5, 6), copy.Coerce<Diadem::Location>());
+  EXPECT_FALSE(
+      Diadem::Spacing(1, 2, 3, 4) != spacing.Coerce<Diadem::Spacing>());
+  EXPECT_STREQ("text", text.Coerce<Diadem::String>().Get());
+}
+
+#if __cplusplus >= 201103L
+TEST(ValueTest, Move) {
+  Diadem::Value size(Diadem::Size(7, 8)), text("text");
+  Diadem::Value moved_size(std::move(size)), moved_text(std::move(text));
+
+  EXPECT_EQ(Diadem::Size(7, 8), moved_size.Coerce<Diadem::Size>());
+  EXPECT_STREQ("text", moved_text.Coerce<Diadem::String>().Get());
+  EXPECT_FALSE(size.IsValid());
+  EXPECT_FALSE(text.IsValid());
+
+  size = std::move(moved_text);
+  EXPECT_STREQ("text", size.Coerce<Diadem::String>().Get());
+  text = std::move(moved_size);
+  EXPECT_EQ(Diadem::Size(7, 8), text.Coerce<Diadem::Size>());
+}
+#endif
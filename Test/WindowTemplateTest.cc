@@ -0,0 +1,178 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "Diadem/Factory.h"
+#include "Diadem/LibXMLParser.h"
+#include "Diadem/NativeHeadless.h"
+#include "Diadem/WindowTemplate.h"
+
+namespace {
+
+const char kTemplateWindow[] =
+    "<window text='Template' direction='column'>"
+      "<labelgroup text='Name:'><edit name='name' width='20em'/></labelgroup>"
+      "<check text='Remember' name='check'/>"
+      "<group><button text='Cancel'/><button text='OK' name='ok'/></group>"
+    "</window>";
+
+class WindowTemplateTest : public testing::Test {
+ public:
+  WindowTemplateTest() {
+    Diadem::Headless::SetUpFactory(&factory_);
+    strcpy(path_, "/tmp/WindowTemplateTestXXXXXX");
+    close(mkstemp(path_));
+  }
+  ~WindowTemplateTest() { unlink(path_); }
+
+  // Writes the file, and sets its modification time.
+  void WriteFile(const char *contents, time_t modified) {
+    FILE* const file = fopen(path_, "w");
+
+    ASSERT_TRUE(file != NULL);
+    fputs(contents, file);
+    fclose(file);
+
+    struct timeval times[2] = { { modified, 0 }, { modified, 0 } };
+
+    ASSERT_EQ(0, utimes(path_, times));
+  }
+
+  Diadem::Factory factory_;
+  char path_[32];
+};
+
+void ExpectSameTree(Diadem::Entity *expected, Diadem::Entity *actual) {
+  EXPECT_EQ(expected->GetTypeName(), actual->GetTypeName());
+  EXPECT_STREQ(expected->GetName(), actual->GetName());
+  EXPECT_EQ(expected->GetLayout()->GetSize(), actual->GetLayout()->GetSize());
+  EXPECT_EQ(expected->GetLayout()->GetLocation(),
+            actual->GetLayout()->GetLocation());
+  ASSERT_EQ(expected->ChildrenCount(), actual->ChildrenCount());
+  for (size_t i = 0; i < expected->ChildrenCount(); ++i)
+    ExpectSameTree(expected->ChildAt(i), actual->ChildAt(i));
+}
+
+}  // namespace
+
+// Each window from a template is separate, and is the same as one that was
+// parsed directly.
+TEST_F(WindowTemplateTest, CreateWindow) {
+  Diadem::WindowTemplate* const window_template =
+      Diadem::WindowTemplate::LoadFromData(factory_, kTemplateWindow);
+
+  ASSERT_TRUE(window_template != NULL);
+
+  Diadem::Entity* const expected =
+      Diadem::LibXMLParser(factory_).LoadEntityFromData(kTemplateWindow);
+  Diadem::Window* const first = window_template->CreateWindow();
+  Diadem::Window* const second = window_template->CreateWindow();
+
+  // The windows outlast the template.
+  delete window_template;
+  ASSERT_TRUE(expected != NULL);
+  ASSERT_TRUE(first != NULL);
+  ASSERT_TRUE(second != NULL);
+  expected->GetLayout()->ResizeToMinimum();
+  first->GetRoot()->GetLayout()->ResizeToMinimum();
+  second->GetRoot()->GetLayout()->ResizeToMinimum();
+  ExpectSameTree(expected, first->GetRoot());
+  ExpectSameTree(expected, second->GetRoot());
+
+  Diadem::Entity* const check = first->GetRoot()->FindByName("check");
+
+  check->SetProperty(Diadem::kPropValue, 1);
+  EXPECT_EQ(0, second->GetRoot()->FindByName("check")->GetProperty(
+      Diadem::kPropValue).Coerce<int32_t>());
+  delete expected;
+  delete first;
+  delete second;
+
+  // A template that isn't a window can still create entities.
+  Diadem::WindowTemplate* const group_template =
+      Diadem::WindowTemplate::LoadFromData(factory_, "<group/>");
+
+  ASSERT_TRUE(group_template != NULL);
+  EXPECT_EQ((Diadem::Window*)NULL, group_template->CreateWindow());
+
+  Diadem::Entity* const group = group_template->CreateEntity();
+
+  ASSERT_TRUE(group != NULL);
+  delete group;
+  delete group_template;
+  EXPECT_EQ((Diadem::WindowTemplate*)NULL,
+            Diadem::WindowTemplate::LoadFromData(factory_, "<group>"));
+}
+
+// The cache reuses templates until their files change.
+TEST_F(WindowTemplateTest, Cache) {
+  Diadem::WindowTemplateCache cache(factory_, 2);
+
+  WriteFile(kTemplateWindow, 1000000);
+
+  const Diadem::WindowTemplate* const window_template =
+      cache.GetTemplate(path_);
+
+  ASSERT_TRUE(window_template != NULL);
+  EXPECT_EQ(window_template, cache.GetTemplate(path_));
+
+  Diadem::Window *window = cache.CreateWindow(path_);
+
+  ASSERT_TRUE(window != NULL);
+  EXPECT_TRUE(window->GetRoot()->FindByName("ok") != NULL);
+  delete window;
+
+  WriteFile("<window text='Changed'><button name='changed'/></window>",
+            2000000);
+  window = cache.CreateWindow(path_);
+  ASSERT_TRUE(window != NULL);
+  EXPECT_TRUE(window->GetRoot()->FindByName("ok") == NULL);
+  EXPECT_TRUE(window->GetRoot()->FindByName("changed") != NULL);
+  delete window;
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ((Diadem::WindowTemplate*)NULL,
+            cache.GetTemplate("/nonexistent/file.dem"));
+}
+
+// The least recently used template is dropped when the cache is full.
+TEST_F(WindowTemplateTest, CacheCapacity) {
+  char paths[3][32];
+  Diadem::WindowTemplateCache cache(factory_, 2);
+  const Diadem::WindowTemplate *templates[3];
+
+  for (int i = 0; i < 3; ++i) {
+    strcpy(paths[i], "/tmp/WindowTemplateTestXXXXXX");
+    close(mkstemp(paths[i]));
+
+    FILE* const file = fopen(paths[i], "w");
+
+    fputs(kTemplateWindow, file);
+    fclose(file);
+  }
+  templates[0] = cache.GetTemplate(paths[0]);
+  templates[1] = cache.GetTemplate(paths[1]);
+  EXPECT_EQ(templates[0], cache.GetTemplate(paths[0]));
+  templates[2] = cache.GetTemplate(paths[2]);  // Drops paths[1]
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(templates[0], cache.GetTemplate(paths[0]));
+  EXPECT_EQ(templates[2], cache.GetTemplate(paths[2]));
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+  for (int i = 0; i < 3; ++i)
+    unlink(paths[i]);
+}
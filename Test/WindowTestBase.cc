@@ -14,6 +14,8 @@
 
 #include "Diadem/Test/WindowTestBase.h"
 #include "Diadem/Factory.h"
+#include "Diadem/FlatLayout.h"
+#include "Diadem/Layout.h"
 
 #ifndef DIADEM_TEST_PARSER
 #include "Diadem/LibXMLParser.h"
@@ -30,11 +32,16 @@
 #include "Diadem/NativeCocoa.h"
 #define DIADEM_PLATFORM Diadem::Cocoa
 #endif
+#else
+#include "Diadem/NativeHeadless.h"
+#define DIADEM_PLATFORM Diadem::Headless
 #endif
 
 #endif  // DIADEM_PLATFORM
 
 void WindowTestBase::TearDown() {
+  if (compareFlatLayout_ && readSucceeded_ && !HasFatalFailure())
+    CompareFlatLayout();
   delete windowObject_;
 }
 
@@ -63,3 +70,72 @@ void WindowTestBase::ReadWindowData_(const char *data) {
     readSucceeded_ = true;
   }
 }
+
+void WindowTestBase::CompareFlatLayout(Diadem::FlatLayout *flat) {
+  Diadem::Layout* const root_layout = windowRoot_->GetLayout();
+  std::vector<int32_t> expected, actual;
+
+  // The test may have resized the window or moved objects in it, so both
+  // start from scratch.
+  InvalidateAll(windowRoot_);
+  root_layout->ResizeToMinimum();
+  GetGeometry(windowRoot_, &expected);
+  InvalidateAll(windowRoot_);
+  flat->ResizeToMinimum();
+  EXPECT_EQ(CountLayouts(windowRoot_), flat->NodeCount());
+  GetGeometry(windowRoot_, &actual);
+  EXPECT_EQ(expected, actual) << "At the minimum size";
+
+  Diadem::Size larger = root_layout->GetSize();
+
+  larger.width += 40;
+  larger.height += 30;
+  actual.clear();
+  flat->SetSize(larger);
+  GetGeometry(windowRoot_, &actual);
+  root_layout->ResizeToMinimum();
+  expected.clear();
+  root_layout->SetSize(larger);
+  GetGeometry(windowRoot_, &expected);
+  EXPECT_EQ(expected, actual) << "At a larger size";
+}
+
+void WindowTestBase::CompareFlatLayout() {
+  Diadem::FlatLayout flat(windowRoot_->GetLayout());
+
+  CompareFlatLayout(&flat);
+}
+
+void WindowTestBase::GetGeometry(
+    Diadem::Entity *entity, std::vector<int32_t> *geometry) {
+  Diadem::Layout* const layout = entity->GetLayout();
+
+  if (layout != NULL) {
+    const Diadem::Size size = layout->GetSize();
+    const Diadem::Location loc = layout->GetLocation();
+
+    geometry->push_back(size.width);
+    geometry->push_back(size.height);
+    if (entity->GetParent() != NULL) {  // The window can be moved
+      geometry->push_back(loc.x);
+      geometry->push_back(loc.y);
+    }
+  }
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    GetGeometry(entity->ChildAt(i), geometry);
+}
+
+size_t WindowTestBase::CountLayouts(Diadem::Entity *entity) {
+  size_t count = (entity->GetLayout() == NULL) ? 0 : 1;
+
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    count += CountLayouts(entity->ChildAt(i));
+  return count;
+}
+
+void WindowTestBase::InvalidateAll(Diadem::Entity *entity) {
+  if (entity->GetLayout() != NULL)
+    entity->GetLayout()->InvalidateLayout();
+  for (size_t i = 0; i < entity->ChildrenCount(); ++i)
+    InvalidateAll(entity->ChildAt(i));
+}
@@ -14,16 +14,26 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "Diadem/Window.h"
 
+namespace Diadem {
+class FlatLayout;
+}
+
 class WindowTestBase : public testing::Test {
  public:
-  WindowTestBase() : windowObject_(NULL), readSucceeded_(false) {}
+  WindowTestBase()
+      : windowObject_(NULL), readSucceeded_(false),
+        compareFlatLayout_(false) {}
 
  protected:
   Diadem::Window *windowObject_;
   Diadem::Entity *windowRoot_;
   bool readSucceeded_;
+  // If set, TearDown() calls CompareFlatLayout() on the test's window.
+  bool compareFlatLayout_;
 
   virtual void TearDown();
 
@@ -32,6 +42,18 @@ class WindowTestBase : public testing::Test {
     return windowObject_->GetRoot()->GetProperty(
         Diadem::kPropMargins).Coerce<Diadem::Spacing>();
   }
+
+  // Lays out the window with its layout objects and with the FlatLayout,
+  // at the minimum size and at a larger size, and checks that the results
+  // are the same.
+  void CompareFlatLayout(Diadem::FlatLayout *flat);
+  void CompareFlatLayout();
+
+  // Appends the size and location of the entity's layout object, and those
+  // of its descendants.
+  void GetGeometry(Diadem::Entity *entity, std::vector<int32_t> *geometry);
+  size_t CountLayouts(Diadem::Entity *entity);
+  void InvalidateAll(Diadem::Entity *entity);
 };
 
 #define ReadWindowData(_data_) \
@@ -49,3 +49,42 @@ void XMLTest::NestedTest() {
   delete result;
   delete parser;
 }
+
+// Entities for other platforms are skipped, along with their children
+void XMLTest::OSTest() {
+  Diadem::Factory factory;
+
+  factory.Register<Diadem::Entity>("entity");
+
+  Diadem::Parser *parser = MakeParser(factory);
+  Diadem::Entity *result = parser->LoadEntityFromData(
+      "<entity name='outside'>"
+        "<entity name='other' os='other'>"
+          "<entity name='otherchild'/>"
+        "</entity>"
+        "<entity name='inside'/>"
+      "</entity>");
+
+  ASSERT_NE((Diadem::Entity*)NULL, result);
+  EXPECT_STREQ("outside", result->GetName());
+  ASSERT_EQ(1, result->ChildrenCount());
+  EXPECT_STREQ("inside", result->ChildAt(0)->GetName());
+  EXPECT_EQ(0, result->ChildAt(0)->ChildrenCount());
+  delete result;
+  delete parser;
+}
+
+// Nothing is loaded from an invalid document
+void XMLTest::MalformedTest() {
+  Diadem::Factory factory;
+
+  factory.Register<Diadem::Entity>("entity");
+
+  Diadem::Parser *parser = MakeParser(factory);
+
+  EXPECT_EQ((Diadem::Entity*)NULL, parser->LoadEntityFromData(
+      "<entity name='outside'>"
+        "<entity name='inside'/>"
+      "</outside>"));
+  delete parser;
+}
@@ -28,8 +28,12 @@ class XMLTest : public testing::Test {
 
   void SimpleTest();
   void NestedTest();
+  void OSTest();
+  void MalformedTest();
 };
 
 #define XML_TESTS(_subclass_) \
     TEST_F(_subclass_, Simple) { SimpleTest(); } \
-    TEST_F(_subclass_, Nested) { NestedTest(); }
+    TEST_F(_subclass_, Nested) { NestedTest(); } \
+    TEST_F(_subclass_, OS) { OSTest(); } \
+    TEST_F(_subclass_, Malformed) { MalformedTest(); }
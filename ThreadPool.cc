@@ -0,0 +1,175 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/ThreadPool.h"
+
+#include <unistd.h>
+
+namespace Diadem {
+
+namespace {
+
+struct ThreadStart {
+  ThreadPool *pool;
+  size_t queue_index;
+};
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t thread_count)
+    : generation_(0), pending_(0), stopping_(false) {
+  if (thread_count == 0) {
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+    thread_count = (processors > 1) ? (processors - 1) : 0;
+  }
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&work_ready_, NULL);
+  pthread_cond_init(&work_done_, NULL);
+  for (size_t i = 0; i <= thread_count; ++i) {
+    Queue* const queue = new Queue;
+
+    pthread_mutex_init(&queue->mutex, NULL);
+    queues_.push_back(queue);
+  }
+  for (size_t i = 0; i < thread_count; ++i) {
+    ThreadStart* const start = new ThreadStart;
+    pthread_t thread;
+
+    start->pool = this;
+    start->queue_index = i + 1;
+    if (pthread_create(&thread, NULL, &ThreadMain, start) != 0) {
+      delete start;
+      break;
+    }
+    threads_.push_back(thread);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  pthread_mutex_lock(&mutex_);
+  stopping_ = true;
+  pthread_cond_broadcast(&work_ready_);
+  pthread_mutex_unlock(&mutex_);
+  for (size_t i = 0; i < threads_.size(); ++i)
+    pthread_join(threads_[i], NULL);
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    pthread_mutex_destroy(&queues_[i]->mutex);
+    delete queues_[i];
+  }
+  pthread_cond_destroy(&work_done_);
+  pthread_cond_destroy(&work_ready_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+void ThreadPool::Run(const Array<Task*> &tasks) {
+  if (threads_.empty()) {
+    for (size_t i = 0; i < tasks.size(); ++i)
+      tasks[i]->Run();
+    return;
+  }
+  if (tasks.empty())
+    return;
+
+  // Threads still looking for work from the last batch may start on this
+  // one as soon as it is queued, so the count has to be set first.
+  pthread_mutex_lock(&mutex_);
+  pending_ = tasks.size();
+  pthread_mutex_unlock(&mutex_);
+
+  // Only threads that have started get tasks of their own; the rest of the
+  // queues stay empty.
+  const size_t queue_count = threads_.size() + 1;
+
+  for (size_t q = 0; q < queue_count; ++q) {
+    Queue* const queue = queues_[q];
+
+    pthread_mutex_lock(&queue->mutex);
+    for (size_t i = q; i < tasks.size(); i += queue_count)
+      queue->tasks.push_back(tasks[i]);
+    pthread_mutex_unlock(&queue->mutex);
+  }
+
+  pthread_mutex_lock(&mutex_);
+  ++generation_;
+  pthread_cond_broadcast(&work_ready_);
+  pthread_mutex_unlock(&mutex_);
+
+  RunTasks(0);
+
+  pthread_mutex_lock(&mutex_);
+  while (pending_ != 0)
+    pthread_cond_wait(&work_done_, &mutex_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void ThreadPool::RunTasks(size_t queue_index) {
+  for (Task *task = TakeTask(queue_index); task != NULL;
+       task = TakeTask(queue_index)) {
+    task->Run();
+    pthread_mutex_lock(&mutex_);
+    if (--pending_ == 0)
+      pthread_cond_signal(&work_done_);
+    pthread_mutex_unlock(&mutex_);
+  }
+}
+
+ThreadPool::Task* ThreadPool::TakeTask(size_t queue_index) {
+  Task *task = NULL;
+  Queue *queue = queues_[queue_index];
+
+  pthread_mutex_lock(&queue->mutex);
+  if (queue->tasks.size() > queue->front) {
+    task = queue->tasks.back();
+    queue->tasks.pop_back();
+  }
+  if (queue->tasks.size() <= queue->front) {
+    queue->tasks.clear();
+    queue->front = 0;
+  }
+  pthread_mutex_unlock(&queue->mutex);
+
+  for (size_t i = 1; (task == NULL) && (i < queues_.size()); ++i) {
+    queue = queues_[(queue_index + i) % queues_.size()];
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->tasks.size() > queue->front)
+      task = queue->tasks[queue->front++];
+    pthread_mutex_unlock(&queue->mutex);
+  }
+  return task;
+}
+
+void* ThreadPool::ThreadMain(void *arg) {
+  ThreadStart* const start = static_cast<ThreadStart*>(arg);
+  ThreadPool* const pool = start->pool;
+  const size_t queue_index = start->queue_index;
+  size_t generation = 0;
+
+  delete start;
+  pthread_mutex_lock(&pool->mutex_);
+  for (;;) {
+    while (!pool->stopping_ && (pool->generation_ == generation))
+      pthread_cond_wait(&pool->work_ready_, &pool->mutex_);
+    if (pool->stopping_)
+      break;
+    generation = pool->generation_;
+    pthread_mutex_unlock(&pool->mutex_);
+    pool->RunTasks(queue_index);
+    pthread_mutex_lock(&pool->mutex_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return NULL;
+}
+
+}  // namespace Diadem
@@ -0,0 +1,84 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_THREADPOOL_H_
+#define DIADEM_THREADPOOL_H_
+
+#include <pthread.h>
+
+#include "Diadem/Wrappers.h"
+
+namespace Diadem {
+
+// Runs batches of tasks on a fixed set of worker threads. Each thread,
+// including the one that calls Run(), has its own queue of tasks, and a
+// thread whose queue is empty takes tasks from the others, so the work stays
+// balanced when some tasks take longer than others.
+class ThreadPool {
+ public:
+  class Task {
+   public:
+    virtual ~Task() {}
+    virtual void Run() = 0;
+  };
+
+  // With a thread count of 0, there is one thread for each processor, not
+  // counting the thread that calls Run().
+  explicit ThreadPool(size_t thread_count = 0);
+  ~ThreadPool();
+
+  // The number of worker threads. If it is 0, Run() runs the tasks in order
+  // on the calling thread.
+  size_t ThreadCount() const { return threads_.size(); }
+
+  // Runs all the tasks and returns when they have finished. The calling
+  // thread runs tasks too. Tasks must not call Run() on the same pool.
+  void Run(const Array<Task*> &tasks);
+
+ protected:
+  // Tasks are taken from the back by the queue's own thread, and from the
+  // front by other threads.
+  struct Queue {
+    Queue() : front(0) {}
+
+    pthread_mutex_t mutex;
+    Array<Task*> tasks;
+    size_t front;
+  };
+
+  Array<pthread_t> threads_;
+  Array<Queue*> queues_;  // queues_[0] belongs to the thread calling Run()
+
+  pthread_mutex_t mutex_;
+  pthread_cond_t work_ready_, work_done_;
+  size_t generation_;  // Incremented for each call to Run()
+  size_t pending_;     // Tasks in the current batch that have not finished
+  bool stopping_;
+
+  // Runs tasks until there are none left in any queue.
+  void RunTasks(size_t queue_index);
+  // Returns NULL if all the queues are empty.
+  Task* TakeTask(size_t queue_index);
+
+  static void* ThreadMain(void *arg);
+
+ private:
+  // Disallow copying
+  ThreadPool(const ThreadPool&);
+  void operator=(const ThreadPool&);
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_THREADPOOL_H_
@@ -0,0 +1,65 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compiles a .dem resource into the .demb format that CompiledParser loads:
+//   demc [-os <platform>] input.dem output.demb
+// The platform is the value of the os property to keep, which defaults to
+// the one demc was built for. The output is written to a temporary file and
+// then renamed, so that a loaded copy that is still mapped isn't changed.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "Diadem/LibXMLCompiler.h"
+
+int main(int argc, char **argv) {
+  const char *os_name = Diadem::FactorySession::OSName();
+  int arg = 1;
+
+  if ((argc > arg + 1) && (strcmp(argv[arg], "-os") == 0)) {
+    os_name = argv[arg + 1];
+    arg += 2;
+  }
+  if (argc != arg + 2) {
+    fprintf(stderr, "usage: %s [-os <platform>] input.dem output.demb\n",
+            argv[0]);
+    return 2;
+  }
+
+  const char* const input_path = argv[arg];
+  const char* const output_path = argv[arg + 1];
+  Diadem::Array<char> output;
+
+  if (!Diadem::LibXMLCompiler(os_name).CompileFile(input_path, &output)) {
+    fprintf(stderr, "%s: could not compile %s\n", argv[0], input_path);
+    return 1;
+  }
+
+  const std::string temp_path = std::string(output_path) + ".tmp";
+  FILE* const file = fopen(temp_path.c_str(), "wb");
+  bool written = false;
+
+  if (file != NULL) {
+    written = fwrite(&output[0], 1, output.size(), file) == output.size();
+    written = (fclose(file) == 0) && written;
+  }
+  if (!written || (rename(temp_path.c_str(), output_path) != 0)) {
+    fprintf(stderr, "%s: could not write %s\n", argv[0], output_path);
+    remove(temp_path.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -18,11 +18,10 @@ namespace Diadem {
 
 Value& Value::operator=(const Value &v) {
   if (this != &v) {
-    delete holder_;
-    if (v.holder_ == NULL)
-      holder_ = NULL;
-    else
-      holder_ = v.holder_->Copy();
+    Clear();
+    if (v.holder_ != NULL)
+      holder_ = v.holder_->Copy(storage_.buffer);
+    type_tag_ = v.type_tag_;
   }
   return *this;
 }
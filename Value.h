@@ -29,6 +29,8 @@ typedef PyObject *PyObjectPtr;
 using std::type_info;
 #endif
 
+#include <new>
+
 #include "Diadem/Wrappers.h"
 #include "Diadem/Entity.h"
 #include "Diadem/Metrics.h"
@@ -37,18 +39,90 @@ namespace Diadem {
 
 class ListDataInterface;
 
+// Values of these types are stored inside the Value object itself instead of
+// being allocated on the heap. They are all small and trivially copyable, and
+// they make up most of the traffic during layout.
+template <class T> struct ValueStoredInline { enum { value = false }; };
+
+#define ValueStoreInline(T) \
+  template <> struct ValueStoredInline<T> { enum { value = true }; };
+
+ValueStoreInline(bool)
+ValueStoreInline(int32_t)
+ValueStoreInline(uint32_t)
+ValueStoreInline(int64_t)
+ValueStoreInline(size_t)
+ValueStoreInline(double)
+ValueStoreInline(Size)
+ValueStoreInline(Spacing)
+ValueStoreInline(Location)
+
+#undef ValueStoreInline
+
+// Each type that Value commonly holds has a tag, so Coerce can check the
+// stored type with an integer comparison and look up conversions in a table
+// instead of using RTTI. Other types fall back to typeid and dynamic_cast.
+enum ValueTypeTag {
+  kValueTypeNone,
+  kValueTypeBool,
+  kValueTypeInt32,
+  kValueTypeUInt32,
+  kValueTypeInt64,
+  kValueTypeSizeT,
+  kValueTypeString,
+  kValueTypeDouble,
+  kValueTypeSize,
+  kValueTypeSpacing,
+  kValueTypeLocation,
+  kValueTypeListData,
+#if DIADEM_PYTHON
+  kValueTypePyObject,
+#endif
+  kValueTypeCount,
+  kValueTypeOther = kValueTypeCount
+};
+
+template <class T> struct ValueTypeOf
+  { static const ValueTypeTag tag = kValueTypeOther; };
+
+#define ValueTagType(T, t) \
+  template <> struct ValueTypeOf<T> { static const ValueTypeTag tag = t; };
+
+ValueTagType(bool, kValueTypeBool)
+ValueTagType(int32_t, kValueTypeInt32)
+ValueTagType(uint32_t, kValueTypeUInt32)
+ValueTagType(int64_t, kValueTypeInt64)
+ValueTagType(size_t, kValueTypeSizeT)
+ValueTagType(String, kValueTypeString)
+ValueTagType(double, kValueTypeDouble)
+ValueTagType(Size, kValueTypeSize)
+ValueTagType(Spacing, kValueTypeSpacing)
+ValueTagType(Location, kValueTypeLocation)
+ValueTagType(ListDataInterface*, kValueTypeListData)
+#if DIADEM_PYTHON
+ValueTagType(PyObjectPtr, kValueTypePyObject)
+#endif
+
+#undef ValueTagType
+
 // Generic value holder based roughly on boost::any, but also with type
 // conversions using the Coerce method.
 class Value {
  public:
-  Value() : holder_(NULL) {}
+  Value() : holder_(NULL), type_tag_(kValueTypeNone) {}
   Value(const Value& value)
-      : holder_((value.holder_ == NULL) ? NULL : value.holder_->Copy()) {}
+      : holder_((value.holder_ == NULL) ?
+          NULL : value.holder_->Copy(storage_.buffer)),
+        type_tag_(value.type_tag_) {}
+#if __cplusplus >= 201103L
+  Value(Value &&value) : holder_(NULL), type_tag_(kValueTypeNone)
+    { Take(&value); }
+#endif
 
-  Value(const char *str) : holder_(new ValueHolder<String>(str)) {}
+  Value(const char *str) : holder_(NULL) { Construct(String(str)); }
 
 #define Value_Construct(T) \
-  Value(const T &t) : holder_(new ValueHolder<T>(t)) {}
+  Value(const T &t) : holder_(NULL) { Construct(t); }
 
   Value_Construct(bool)
   Value_Construct(int32_t)
@@ -67,27 +141,33 @@ class Value {
 #undef Value_Construct
 
   // The macro doesn't work with pointers
-  Value(ListDataInterface *data)
-      : holder_(new ValueHolder<ListDataInterface*>(data)) {}
+  Value(ListDataInterface *data) : holder_(NULL) { Construct(data); }
 
   template <class T>
   Value& operator=(const T &t) {
-    delete holder_;
-    holder_ = new ValueHolder<T>(t);
+    Clear();
+    Construct(t);
     return *this;
   }
 
-  ~Value() { delete holder_; }
+  ~Value() { Clear(); }
 
   bool IsValid() const { return holder_ != NULL; }
 
   template <class T>
-  bool IsValueType() const
-    { return (holder_ != NULL) && (holder_->Type() == typeid(T)); }
+  bool IsValueType() const {
+    if (ValueTypeOf<T>::tag != kValueTypeOther)
+      return type_tag_ == ValueTypeOf<T>::tag;
+    return (holder_ != NULL) && (holder_->Type() == typeid(T));
+  }
 
   void Clear() {
-    delete holder_;
+    if (IsStoredInline())
+      holder_->~ValueHolderBase();
+    else
+      delete holder_;
     holder_ = NULL;
+    type_tag_ = kValueTypeNone;
   }
 
   // Used to call different overloads of ValueHolder::Coerce
@@ -100,13 +180,25 @@ class Value {
   T Coerce() const {
     if (holder_ == NULL)
       return T();
-    ValueHolder<T> *t_holder = dynamic_cast<ValueHolder<T>*>(holder_);
-    if (t_holder != NULL)
-      return t_holder->data;
-    return holder_->Coerce(type<T>());
+    if (ValueTypeOf<T>::tag != kValueTypeOther) {
+      if (type_tag_ == ValueTypeOf<T>::tag)
+        return static_cast<const ValueHolder<T>*>(holder_)->data;
+      if (type_tag_ != kValueTypeOther)
+        return Coercions<T>::table[type_tag_](holder_);
+    }
+    return CoerceWithRTTI<T>();
   }
 
   Value& operator=(const Value& v);
+#if __cplusplus >= 201103L
+  Value& operator=(Value &&v) {
+    if (this != &v) {
+      Clear();
+      Take(&v);
+    }
+    return *this;
+  }
+#endif
 
   Value& operator=(const char *str)
     { return operator=(String(str)); }
@@ -118,7 +210,9 @@ class Value {
    public:
     virtual ~ValueHolderBase() {}
     virtual const type_info& Type() = 0;
-    virtual ValueHolderBase* Copy() = 0;
+    // Copies the holder into buffer if the type is stored inline, or onto
+    // the heap if not.
+    virtual ValueHolderBase* Copy(void *buffer) = 0;
 
     // Each type variant must be declared explicitly because method templates
     // cannot be virtual.
@@ -149,7 +243,11 @@ class Value {
     ValueHolder(const T& value) : data(value) {}
 
     const type_info& Type()       { return typeid(T); }
-    ValueHolderBase* Copy()       { return new ValueHolder<T>(data); }
+    ValueHolderBase* Copy(void *buffer) {
+      if (ValueStoredInline<T>::value)
+        return new(buffer) ValueHolder<T>(data);
+      return new ValueHolder<T>(data);
+    }
 
     // For types where simple casts are not enough, these are overridden
     // by specializations below.
@@ -170,7 +268,118 @@ class Value {
     const T data;
   };
 
+  // Converts the contents of a ValueHolder<S> to T by calling the Coerce
+  // overload directly instead of through the vtable.
+  template <class S, class T,
+            bool has_overload = (ValueTypeOf<T>::tag != kValueTypeOther) &&
+                                (ValueTypeOf<T>::tag != kValueTypeSize) &&
+                                (ValueTypeOf<T>::tag != kValueTypeLocation) &&
+                                (ValueTypeOf<T>::tag != kValueTypeListData)>
+  struct Converter {
+    static T Convert(const ValueHolderBase *holder) {
+      return static_cast<const ValueHolder<S>*>(holder)->
+          ValueHolder<S>::Coerce(type<T>());
+    }
+  };
+
+  // ValueHolderBase has no virtual Coerce for these types, so the template
+  // version would have been called.
+  template <class S, class T>
+  struct Converter<S, T, false> {
+    static T Convert(const ValueHolderBase *holder) {
+      DASSERT(false);
+      return T();
+    }
+  };
+
+  // For each result type there is a table of conversion functions, indexed
+  // by the tag of the stored type.
+  template <class T>
+  struct Coercions {
+    typedef T (*Function)(const ValueHolderBase *holder);
+    static const Function table[kValueTypeCount];
+  };
+
+  // Spacing is the largest of the inline types.
+  union InlineStorage {
+    char buffer[sizeof(ValueHolder<Spacing>)];
+    void *align_pointer;
+    int64_t align_int64;
+    double align_double;
+  };
+
+  // Points into storage_ for inline types, or to the heap otherwise.
   ValueHolderBase *holder_;
+  InlineStorage storage_;
+  ValueTypeTag type_tag_;
+
+  bool IsStoredInline() const {
+    return static_cast<const void*>(holder_) == storage_.buffer;
+  }
+
+  // Expects holder_ to be NULL.
+  template <class T>
+  void Construct(const T &t) {
+#if __cplusplus >= 201103L
+    static_assert(!ValueStoredInline<T>::value ||
+                      (sizeof(ValueHolder<T>) <= sizeof(storage_)),
+                  "inline ValueHolder does not fit in the storage");
+#else
+    enum { kHolderFitsInline = sizeof(char[
+        (!ValueStoredInline<T>::value ||
+         (sizeof(ValueHolder<T>) <= sizeof(storage_))) ? 1 : -1]) };
+#endif
+    if (ValueStoredInline<T>::value) {
+      holder_ = new(storage_.buffer) ValueHolder<T>(t);
+    } else {
+      holder_ = new ValueHolder<T>(t);
+    }
+    type_tag_ = ValueTypeOf<T>::tag;
+  }
+
+  // The original conversion path, for types that don't have tags.
+  template <class T>
+  T CoerceWithRTTI() const {
+    ValueHolder<T> *t_holder = dynamic_cast<ValueHolder<T>*>(holder_);
+    if (t_holder != NULL)
+      return t_holder->data;
+    return holder_->Coerce(type<T>());
+  }
+
+  // Moves the contents of value into this object, which must be empty.
+  // Heap holders change owners; inline ones are copied.
+  void Take(Value *value) {
+    if (value->IsStoredInline()) {
+      holder_ = value->holder_->Copy(storage_.buffer);
+      type_tag_ = value->type_tag_;
+      value->Clear();
+    } else {
+      holder_ = value->holder_;
+      type_tag_ = value->type_tag_;
+      value->holder_ = NULL;
+      value->type_tag_ = kValueTypeNone;
+    }
+  }
+};
+
+template <class T>
+const typename Value::Coercions<T>::Function
+    Value::Coercions<T>::table[kValueTypeCount] = {
+  NULL,  // kValueTypeNone
+  &Value::Converter<bool, T>::Convert,
+  &Value::Converter<int32_t, T>::Convert,
+  &Value::Converter<uint32_t, T>::Convert,
+  &Value::Converter<int64_t, T>::Convert,
+  &Value::Converter<size_t, T>::Convert,
+  &Value::Converter<String, T>::Convert,
+  &Value::Converter<double, T>::Convert,
+  &Value::Converter<Size, T>::Convert,
+  &Value::Converter<Spacing, T>::Convert,
+  &Value::Converter<Location, T>::Convert,
+  &Value::Converter<ListDataInterface*, T>::Convert,
+#if DIADEM_PYTHON
+  &Value::Converter<PyObjectPtr, T>::Convert,
+#endif
 };
 
 // TODO(catmull): clean this up using something like tr1::is_pod
@@ -22,8 +22,9 @@ namespace Diadem {
 
 class Window {
  public:
-  Window() { root_ = NULL; }
-  explicit Window(Entity *root) : root_(root) {
+  Window() : root_(NULL), close_callback_(NULL), close_data_(NULL) {}
+  explicit Window(Entity *root)
+      : root_(root), close_callback_(NULL), close_data_(NULL) {
     DASSERT(IsValid());
     root->SetWindow(this);
   }
@@ -45,6 +46,17 @@ class Window {
   bool EndModal()
     { return root_->GetNative()->GetWindowInterface()->EndModal(); }
 
+  // Layout changes only mark the affected parts of the hierarchy. This does
+  // one layout pass for everything that has changed since the last one.
+  void UpdateLayout() {
+    if ((root_ != NULL) && (root_->GetLayout() != NULL))
+      root_->GetLayout()->UpdateLayout();
+  }
+  bool NeedsLayout() const {
+    return (root_ != NULL) && (root_->GetLayout() != NULL) &&
+        root_->GetLayout()->NeedsLayout();
+  }
+
   // Function to be called when the user attempts to close a window. Return
   // false to disallow closing.
   typedef bool (*CloseCallback)(Window *window, void *data);
@@ -60,12 +72,11 @@ class Window {
         true : (*close_callback_)(this, close_data_);
   }
 
+  // Parses the file each time. Windows that are opened repeatedly can be
+  // created from a WindowTemplate instead.
   template <class Platform, class Parser>
   void LoadFromFile(const char *path) {
-    Factory factory;
-
-    Platform::SetUpFactory(factory);
-    root_ = Parser(factory).LoadEntityFromFile(path);
+    root_ = Parser(Factory::Shared<Platform>()).LoadEntityFromFile(path);
     DASSERT(IsValid());
   }
 
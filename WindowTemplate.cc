@@ -0,0 +1,127 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "Diadem/WindowTemplate.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+
+#include "Diadem/CompiledParser.h"
+#include "Diadem/LibXMLCompiler.h"
+
+namespace Diadem {
+
+WindowTemplate* WindowTemplate::LoadFromFile(
+    const Factory &factory, const char *path) {
+  CompiledResource *resource = NULL;
+
+  if (CompiledResource::IsCompiledFile(path)) {
+    resource = CompiledResource::LoadFile(path);
+  } else {
+    Array<char> compiled;
+
+    if (LibXMLCompiler().CompileFile(path, &compiled))
+      resource = CompiledResource::LoadData(&compiled[0], compiled.size());
+  }
+  return (resource == NULL) ? NULL : new WindowTemplate(factory, resource);
+}
+
+WindowTemplate* WindowTemplate::LoadFromData(
+    const Factory &factory, const char *data) {
+  Array<char> compiled;
+
+  if (!LibXMLCompiler().CompileData(data, &compiled))
+    return NULL;
+
+  CompiledResource* const resource =
+      CompiledResource::LoadData(&compiled[0], compiled.size());
+
+  return (resource == NULL) ? NULL : new WindowTemplate(factory, resource);
+}
+
+WindowTemplate::~WindowTemplate() {
+  delete resource_;
+}
+
+Entity* WindowTemplate::CreateEntity() const {
+  return resource_->CreateEntities(factory_);
+}
+
+Window* WindowTemplate::CreateWindow() const {
+  Entity* const root = CreateEntity();
+
+  if (root == NULL)
+    return NULL;
+  if ((root->GetNative() == NULL) ||
+      (root->GetNative()->GetWindowInterface() == NULL)) {
+    delete root;
+    return NULL;
+  }
+  return new Window(root);
+}
+
+const WindowTemplate* WindowTemplateCache::GetTemplate(const char *path) {
+  struct stat info;
+
+  if (stat(path, &info) != 0)
+    return NULL;
+
+  Entry entry = { path, info.st_mtime, info.st_size, NULL };
+
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (entries_[i].path != path)
+      continue;
+    if ((entries_[i].modified == entry.modified) &&
+        (entries_[i].size == entry.size))
+      entry.window_template = entries_[i].window_template;
+    else
+      delete entries_[i].window_template;
+    entries_.erase(entries_.begin() + i);
+    break;
+  }
+  if (entry.window_template == NULL) {
+    entry.window_template = WindowTemplate::LoadFromFile(factory_, path);
+    if (entry.window_template == NULL)
+      return NULL;
+  }
+  entries_.insert(entries_.begin(), entry);
+  // The new entry is kept even if the capacity is 0, so that it can be
+  // returned.
+  while (entries_.size() > std::max<size_t>(capacity_, 1)) {
+    delete entries_.back().window_template;
+    entries_.pop_back();
+  }
+  return entry.window_template;
+}
+
+Entity* WindowTemplateCache::CreateEntity(const char *path) {
+  const WindowTemplate* const window_template = GetTemplate(path);
+
+  return (window_template == NULL) ? NULL : window_template->CreateEntity();
+}
+
+Window* WindowTemplateCache::CreateWindow(const char *path) {
+  const WindowTemplate* const window_template = GetTemplate(path);
+
+  return (window_template == NULL) ? NULL : window_template->CreateWindow();
+}
+
+void WindowTemplateCache::Clear() {
+  for (size_t i = 0; i < entries_.size(); ++i)
+    delete entries_[i].window_template;
+  entries_.clear();
+}
+
+}  // namespace Diadem
@@ -0,0 +1,94 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License.  You may obtain a copy
+// of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#ifndef DIADEM_WINDOWTEMPLATE_H_
+#define DIADEM_WINDOWTEMPLATE_H_
+
+#include <sys/types.h>
+
+#include "Diadem/Window.h"
+
+namespace Diadem {
+
+class CompiledResource;
+
+// A window resource that is loaded once and then used to create any number
+// of windows. XML resources are compiled in memory when they are loaded, and
+// compiled (.demb) ones are memory-mapped, so creating a window does no
+// parsing. The factory is referenced, not copied, so it must outlast the
+// template. Windows should be created on one thread at a time.
+class WindowTemplate : public Base {
+ public:
+  // These return NULL if the resource can't be loaded. LoadFromFile accepts
+  // both XML and compiled files.
+  static WindowTemplate* LoadFromFile(const Factory &factory, const char *path);
+  static WindowTemplate* LoadFromData(const Factory &factory, const char *data);
+
+  virtual ~WindowTemplate();
+
+  // Returns the root of a new entity tree, or a new window.
+  Entity* CreateEntity() const;
+  Window* CreateWindow() const;
+
+ protected:
+  WindowTemplate(const Factory &factory, CompiledResource *resource)
+      : factory_(factory), resource_(resource) {}
+
+  const Factory &factory_;
+  CompiledResource *resource_;
+
+ private:  // Disallow copying
+  WindowTemplate(const WindowTemplate&);
+  void operator=(const WindowTemplate&);
+};
+
+// Keeps the most recently used templates, up to a given number, so that
+// windows that are opened repeatedly are only loaded once. Files are checked
+// for changes each time, and are loaded again if they have been modified.
+class WindowTemplateCache : public Base {
+ public:
+  WindowTemplateCache(const Factory &factory, size_t capacity)
+      : factory_(factory), capacity_(capacity) {}
+  virtual ~WindowTemplateCache() { Clear(); }
+
+  // Returns NULL if the file can't be loaded. The template is owned by the
+  // cache, and may be deleted by the next call to GetTemplate.
+  const WindowTemplate* GetTemplate(const char *path);
+
+  Entity* CreateEntity(const char *path);
+  Window* CreateWindow(const char *path);
+
+  size_t size() const { return entries_.size(); }
+  void Clear();
+
+ protected:
+  struct Entry {
+    String path;
+    time_t modified;
+    off_t size;
+    WindowTemplate *window_template;
+  };
+
+  const Factory &factory_;
+  size_t capacity_;
+  Array<Entry> entries_;  // Most recently used first
+
+ private:  // Disallow copying
+  WindowTemplateCache(const WindowTemplateCache&);
+  void operator=(const WindowTemplateCache&);
+};
+
+}  // namespace Diadem
+
+#endif  // DIADEM_WINDOWTEMPLATE_H_
@@ -32,6 +32,8 @@
 #include <stack>
 #endif
 
+#include <new>
+
 #include "Diadem/Base.h"
 
 #ifndef DIADEM_HAVE_ASSERT
@@ -44,6 +46,16 @@ namespace Diadem {
 // you can create your own wrappers in a previously included header file
 // and #define the appropriate symbols.
 
+#ifndef DIADEM_HAVE_ATOMIC
+#define DIADEM_HAVE_ATOMIC
+// Adds to a value that other threads may be changing at the same time, and
+// returns the new value.
+template <class T>
+inline T AtomicAdd(T *value, T amount) {
+  return __sync_add_and_fetch(value, amount);
+}
+#endif
+
 #ifndef DIADEM_HAVE_ARRAY
 #define DIADEM_HAVE_ARRAY
 template <class T>
@@ -136,64 +148,193 @@ template <class T>
 class Stack : public std::stack<T> {};
 #endif
 
+// Storage that Strings can refer to instead of copying their characters, such
+// as a memory-mapped file. It is deleted when the last reference is released.
+// The count is atomic, since Strings from one storage object may end up in
+// windows used on different threads.
+class SharedStorage : public Base {
+ public:
+  SharedStorage() : references_(1) {}
+
+  void Retain() { AtomicAdd<size_t>(&references_, 1); }
+  void Release() {
+    if (AtomicAdd<size_t>(&references_, -1) == 0)
+      delete this;
+  }
+
+ protected:
+  virtual ~SharedStorage() {}
+
+  size_t references_;
+};
+
 // The String class is different from the above wrapper classes. It is intended
 // for the simple use case of holding an immutable string, so it does not need
-// to involve a more complex class like std::string.
+// to involve a more complex class like std::string. The characters are shared
+// between copies with a reference count, so copying is cheap. The length and
+// hash are computed once when the string is created. Copies of a String
+// should not be created or destroyed on different threads at the same time.
 class String : public Base {
  public:
   enum Adopt { kAdoptBuffer };
 
-  String() : string_(NULL) { Clear(); }
-  String(const char *s)   : string_(NULL) { *this = s; }
-  String(const String &s) : string_(NULL) { *this = s.string_; }
+  String() : buffer_(NULL) {}
+  String(const char *s)   : buffer_(Buffer::Create(s)) {}
+  String(const String &s) : buffer_(s.buffer_) { Retain(); }
   // If the pointer you pass was allocated with new char[], and you want the
   // String object to dispose of it, pass kAdoptBuffer as the second parameter.
-  String(const char *s, Adopt) : string_(s) {}
+  String(const char *s, Adopt) : buffer_(Buffer::AdoptChars(s)) {}
+  // Refers to characters in the storage, which is retained for as long as
+  // the characters are in use. The length and hash are given, such as when
+  // they were computed ahead of time, and the characters must be followed by
+  // a null terminator.
+  String(const char *s, size_t length, uint32_t hash, SharedStorage *storage)
+      : buffer_(Buffer::Refer(s, length, hash, storage)) {}
 
-  ~String() { delete[] string_; }
+  ~String() { Release(); }
 
   void Clear() {
-    char *s = new char[1];
-
-    s[0] = '\0';
-    delete[] string_;
-    string_ = s;
+    Release();
+    buffer_ = NULL;
   }
 
-  bool IsEmpty() const { return strlen(string_) == 0; }
+  bool IsEmpty() const  { return buffer_ == NULL; }
+  size_t Length() const { return (buffer_ == NULL) ? 0 : buffer_->length; }
+  uint32_t Hash() const
+    { return (buffer_ == NULL) ? EmptyHash() : buffer_->hash; }
 
-  const char* Get() const      { return string_; }
-  operator const char*() const { return string_; }
+  const char* Get() const
+    { return (buffer_ == NULL) ? "" : buffer_->chars; }
+  operator const char*() const { return Get(); }
 
   String& operator=(const char *s) {
-    if (s == NULL) {
-      Clear();
-    } else {
-      char *string_copy = new char[strlen(s)+1];
+    // s could point into the current buffer, so copy before releasing.
+    Buffer *buffer = Buffer::Create(s);
 
-      strcpy(string_copy, s);
-      string_ = string_copy;
-    }
+    Release();
+    buffer_ = buffer;
+    return *this;
+  }
+  String& operator=(const String &s) {
+    s.Retain();
+    Release();
+    buffer_ = s.buffer_;
     return *this;
   }
-  String& operator=(const String &s) { return operator=(s.Get()); }
-  bool operator==(const char *s) const { return strcmp(string_, s) == 0; }
-  bool operator!=(const char *s) const { return strcmp(string_, s) != 0; }
+  bool operator==(const String &s) const {
+    if (buffer_ == s.buffer_)
+      return true;
+    if ((Length() != s.Length()) || (Hash() != s.Hash()))
+      return false;
+    return memcmp(Get(), s.Get(), Length()) == 0;
+  }
+  bool operator!=(const String &s) const { return !operator==(s); }
+  bool operator==(const char *s) const { return strcmp(Get(), s) == 0; }
+  bool operator!=(const char *s) const { return strcmp(Get(), s) != 0; }
 
-  int32_t ToInteger() const   { return atoi(string_); }
+  int32_t ToInteger() const   { return atoi(Get()); }
   int64_t ToInteger64() const {
     int64_t value = 0;
 #if TARGET_OS_WIN32
-    sscanf(string_, "%I64d", &value);
+    sscanf(Get(), "%I64d", &value);
 #else
-    sscanf(string_, "%lld", &value);
+    sscanf(Get(), "%lld", &value);
 #endif
     return value;
   }
-  double ToDouble() const { return strtod(string_, NULL); }
+  double ToDouble() const { return strtod(Get(), NULL); }
+
+  // FNV-1a hash, which also measures the string.
+  static uint32_t ComputeHash(const char *s, size_t *length) {
+    uint32_t hash = EmptyHash();
+    const char *c = s;
+
+    for (; *c != '\0'; ++c) {
+      hash ^= static_cast<unsigned char>(*c);
+      hash *= 16777619U;
+    }
+    *length = c - s;
+    return hash;
+  }
 
  protected:
-  const char *string_;
+  static uint32_t EmptyHash() { return 2166136261U; }
+
+  // Shared string data. For copied strings, the header and characters are
+  // one allocation; adopted characters are kept in their own buffer, and
+  // referred characters stay in their SharedStorage.
+  struct Buffer {
+    size_t references;
+    size_t length;
+    uint32_t hash;
+    const char *chars;
+    bool adopted;
+    SharedStorage *storage;  // Holds the characters if not NULL
+
+    static Buffer* Create(const char *s) {
+      if ((s == NULL) || (s[0] == '\0'))
+        return NULL;
+
+      size_t length;
+      const uint32_t hash = ComputeHash(s, &length);
+      char *block = new char[sizeof(Buffer) + length + 1];
+      Buffer *buffer = new(block) Buffer;
+      char *chars = block + sizeof(Buffer);
+
+      memcpy(chars, s, length + 1);
+      buffer->Initialize(chars, length, hash, false);
+      return buffer;
+    }
+    static Buffer* AdoptChars(const char *s) {
+      if ((s == NULL) || (s[0] == '\0')) {
+        delete[] s;
+        return NULL;
+      }
+
+      size_t length;
+      const uint32_t hash = ComputeHash(s, &length);
+      Buffer *buffer = new(new char[sizeof(Buffer)]) Buffer;
+
+      buffer->Initialize(s, length, hash, true);
+      return buffer;
+    }
+    static Buffer* Refer(
+        const char *s, size_t length, uint32_t hash, SharedStorage *storage) {
+      if (length == 0)
+        return NULL;
+
+      Buffer *buffer = new(new char[sizeof(Buffer)]) Buffer;
+
+      buffer->Initialize(s, length, hash, false);
+      buffer->storage = storage;
+      storage->Retain();
+      return buffer;
+    }
+    void Initialize(const char *c, size_t l, uint32_t h, bool a) {
+      references = 1;
+      length = l;
+      hash = h;
+      chars = c;
+      adopted = a;
+      storage = NULL;
+    }
+  };
+
+  Buffer *buffer_;
+
+  void Retain() const {
+    if (buffer_ != NULL)
+      ++buffer_->references;
+  }
+  void Release() {
+    if ((buffer_ != NULL) && (--buffer_->references == 0)) {
+      if (buffer_->adopted)
+        delete[] buffer_->chars;
+      if (buffer_->storage != NULL)
+        buffer_->storage->Release();
+      delete[] reinterpret_cast<char*>(buffer_);
+    }
+  }
 };
 
 inline bool operator<(const String &a, const String &b) {
@@ -202,8 +343,132 @@ inline bool operator<(const String &a, const String &b) {
 
 // Having this makes it easier to declare lots of const char* const variables.
 typedef const char* StringConstant;
-typedef StringConstant PropertyName;
-typedef StringConstant TypeName;
+
+// Hash functions for HashMap keys. C strings hash the same as Strings so they
+// can be used to look up String keys without making a copy.
+inline uint32_t HashKey(const String &s) { return s.Hash(); }
+inline uint32_t HashKey(const char *s) {
+  size_t length;
+
+  return String::ComputeHash(s, &length);
+}
+
+template <class T>
+inline uint32_t HashKey(T *p) {
+  // Pointers are aligned, so the low bits carry no information.
+  return static_cast<uint32_t>(reinterpret_cast<size_t>(p) >> 3) * 2654435761U;
+}
+
+#ifndef DIADEM_HAVE_HASHMAP
+#define DIADEM_HAVE_HASHMAP
+// Unordered map for keys that have a HashKey() overload, used where lookups
+// need to stay fast as the number of entries grows.
+template <class K, class V>
+class HashMap {
+ public:
+  HashMap() : count_(0) {}
+
+  size_t size() const { return count_; }
+  bool Exists(const K &key) const { return Find(key) != NULL; }
+
+  // Returns NULL if the key is not in the map. The key may be any type that
+  // hashes the same as K and can be compared to it.
+  template <class L>
+  V* Find(const L &key) {
+    if (count_ == 0)
+      return NULL;
+
+    Bucket &bucket = buckets_[BucketIndex(key)];
+
+    for (size_t i = 0; i < bucket.size(); ++i)
+      if (bucket[i].key == key)
+        return &bucket[i].value;
+    return NULL;
+  }
+  template <class L>
+  const V* Find(const L &key) const
+    { return const_cast<HashMap*>(this)->Find(key); }
+
+  V operator[](const K &key) const {
+    const V *value = Find(key);
+
+    return (value == NULL) ? V() : *value;
+  }
+
+  // Adds the key and value, replacing any existing value for the key.
+  void Insert(const K &key, const V &value) {
+    V *existing = Find(key);
+
+    if (existing != NULL) {
+      *existing = value;
+      return;
+    }
+    if (count_ >= buckets_.size())
+      Resize((buckets_.size() == 0) ? 16 : buckets_.size() * 2);
+
+    const Entry entry = { key, value };
+
+    buckets_[BucketIndex(key)].push_back(entry);
+    ++count_;
+  }
+
+  // Returns false if the key was not in the map.
+  bool Remove(const K &key) {
+    if (count_ == 0)
+      return false;
+
+    Bucket &bucket = buckets_[BucketIndex(key)];
+
+    for (size_t i = 0; i < bucket.size(); ++i)
+      if (bucket[i].key == key) {
+        bucket[i] = bucket.back();
+        bucket.pop_back();
+        --count_;
+        return true;
+      }
+    return false;
+  }
+
+  void Clear() {
+    buckets_.clear();
+    count_ = 0;
+  }
+
+  Array<K> AllKeys() const {
+    Array<K> result;
+
+    for (size_t b = 0; b < buckets_.size(); ++b)
+      for (size_t i = 0; i < buckets_[b].size(); ++i)
+        result.push_back(buckets_[b][i].key);
+    return result;
+  }
+
+ protected:
+  struct Entry {
+    K key;
+    V value;
+  };
+  typedef Array<Entry> Bucket;
+
+  Array<Bucket> buckets_;  // Size is zero or a power of two.
+  size_t count_;
+
+  template <class L>
+  size_t BucketIndex(const L &key) const
+    { return HashKey(key) & (buckets_.size() - 1); }
+
+  void Resize(size_t bucket_count) {
+    Array<Bucket> old_buckets;
+
+    old_buckets.swap(buckets_);
+    buckets_.resize(bucket_count);
+    for (size_t b = 0; b < old_buckets.size(); ++b)
+      for (size_t i = 0; i < old_buckets[b].size(); ++i)
+        buckets_[BucketIndex(old_buckets[b][i].key)].push_back(
+            old_buckets[b][i]);
+  }
+};
+#endif
 
 }  // namespace Diadem
 
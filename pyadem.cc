@@ -296,7 +296,8 @@ static PyGetSetDef Entity_getsetters[] = {
 
 // Helper used in Entity_getProperty and Entity_getPropertyByName
 static PyObject* GetProperty(Diadem::Entity *entity, PyObject *name) {
-  const Diadem::Value value = entity->GetProperty(PyString_AsString(name));
+  const Diadem::PropertyName prop_name(PyString_AsString(name));
+  const Diadem::Value value = entity->GetProperty(prop_name);
 
   if (!value.IsValid()) {
     PyErr_SetString(PyExc_KeyError, "property not found");
@@ -311,7 +312,9 @@ static PyObject* GetProperty(Diadem::Entity *entity, PyObject *name) {
 // Helper used in Entity_setProperty and Entity_setPropertyByName
 static PyObject* SetProperty(
     Diadem::Entity *entity, PyObject *name, PyObject *value) {
-  if (strcmp(PyString_AsString(name), Diadem::kPropData) == 0) {
+  const Diadem::PropertyName prop_name(PyString_AsString(name));
+
+  if (prop_name == Diadem::kPropData) {
     // Special case: data is a callback object, and must be wrapped
     PyListData *data = new PyListData(value);
 
@@ -321,7 +324,7 @@ static PyObject* SetProperty(
       delete data;
       return NULL;
     }
-  } else if (!entity->SetProperty(PyString_AsString(name), value)) {
+  } else if (!entity->SetProperty(prop_name, value)) {
     PyErr_SetString(PyExc_KeyError, "property not found");
     return NULL;
   }
@@ -380,6 +383,36 @@ static PyObject* Entity_findByName(PyademEntity *self, PyObject *name) {
   return reinterpret_cast<PyObject*>(WrapEntity(entity));
 }
 
+// Holds change notifications until CommitChanges is called.
+static PyObject* Entity_beginChanges(PyademEntity *self) {
+  if (self->object == NULL)
+    return NULL;
+
+  Diadem::ChangeMessenger* const messenger =
+      self->object->GetChangeMessenger();
+
+  if (messenger != NULL)
+    messenger->BeginChanges();
+  Py_RETURN_NONE;
+}
+
+static PyObject* Entity_commitChanges(PyademEntity *self) {
+  if (self->object == NULL)
+    return NULL;
+
+  Diadem::ChangeMessenger* const messenger =
+      self->object->GetChangeMessenger();
+
+  if (messenger != NULL) {
+    if (!messenger->InTransaction()) {
+      PyErr_SetString(PyExc_RuntimeError, "no changes have been begun");
+      return NULL;
+    }
+    messenger->CommitChanges();
+  }
+  Py_RETURN_NONE;
+}
+
 static PyObject* Entity_getPropertyByName(PyademEntity *self, PyObject *args) {
   if (self->object == NULL)
     return NULL;
@@ -420,6 +453,8 @@ static PyMethodDef Entity_methods[] = {
       METH_VARARGS, NULL },
     { "GetPropertyByName", (PyCFunction)Entity_getPropertyByName,
       METH_VARARGS, NULL },
+    { "BeginChanges", (PyCFunction)Entity_beginChanges, METH_NOARGS, NULL },
+    { "CommitChanges", (PyCFunction)Entity_commitChanges, METH_NOARGS, NULL },
     { NULL },
     };
 
@@ -508,6 +543,13 @@ static PyObject* Window_resizeToMinimum(PyademWindow *self) {
   Py_RETURN_NONE;
 }
 
+static PyObject* Window_updateLayout(PyademWindow *self) {
+  if ((self == NULL) || (self->window == NULL))
+    return NULL;
+  self->window->UpdateLayout();
+  Py_RETURN_NONE;
+}
+
 static PyObject* Window_close(PyademWindow *self) {
   if ((self == NULL) || (self->window == NULL))
     return NULL;
@@ -536,6 +578,7 @@ static PyMethodDef Window_methods[] = {
     { "ShowModeless", (PyCFunction)Window_showModeless, METH_NOARGS, NULL },
     { "ResizeToMinimum", (PyCFunction)Window_resizeToMinimum,
       METH_NOARGS, NULL },
+    { "UpdateLayout", (PyCFunction)Window_updateLayout, METH_NOARGS, NULL },
     { "Close",        (PyCFunction)Window_close,        METH_NOARGS, NULL },
     { "ShowModal",    (PyCFunction)Window_showModal,    METH_NOARGS, NULL },
     { "EndModal",     (PyCFunction)Window_endModal,     METH_NOARGS, NULL },